@@ -0,0 +1,354 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionParserBenchmark.cpp
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+// Measures the whole parse LoadInteractionFile does on a miss, decoding the UTF-8 and building every block's runs, without the engine.
+// It runs the loader's own InteractionMarkup::TBlockParser, and each run gets its own shared string like the FInteractionStringTable makes.
+// The table lookup is not measured, so the allocations are the loader's when no run was interned before, such as the first file loaded.
+// Build from this folder with either:
+//   g++ -O2 -std=c++14 -I../Production InteractionParserBenchmark.cpp -o ParserBenchmark
+//   g++ -O2 -std=c++14 -mavx2 -I../Production InteractionParserBenchmark.cpp -o ParserBenchmark
+// Run with the corpus size in MB, 32 by default:
+//   ./ParserBenchmark 64
+
+#include "InteractionMarkupParser.h"
+#include "InteractionTextDecoder.h"
+
+// STL Includes
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h> // malloc_usable_size, this only builds on Linux
+#include <memory>   // make_shared
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+  // Every allocation is counted so the benchmark can report allocations per block and the peak heap size
+  struct FAllocationStats
+  {
+    size_t Count   = 0;
+    size_t Current = 0;
+    size_t Peak    = 0;
+  };
+
+  FAllocationStats AllocationStats;
+}
+
+void *operator new( const size_t Size )
+{
+  void *const Memory = std::malloc( Size );
+
+  if( !Memory ) throw std::bad_alloc{};
+
+  ++AllocationStats.Count;
+
+  AllocationStats.Current += malloc_usable_size( Memory ); // Counts the same size on delete, even if malloc rounded it up
+  AllocationStats.Peak     = std::max( AllocationStats.Peak, AllocationStats.Current );
+
+  return Memory;
+}
+
+void operator delete( void *const Pointer ) NoExcept
+{
+  if( !Pointer ) return;
+
+  AllocationStats.Current -= malloc_usable_size( Pointer );
+
+  std::free( Pointer );
+}
+
+void operator delete( void *const Pointer, size_t ) NoExcept
+{
+  operator delete( Pointer );
+}
+
+namespace
+{
+  using FChar = char16_t; // TCHAR on Windows, which is what we ship on
+
+  // Mirrors FInteractionText, the text of every run is its own shared string
+  struct FTextBlock
+  {
+    struct FRun
+    {
+      std::shared_ptr< const std::vector< FChar > > Text;
+
+      int Markup;
+      int Parameter;
+    };
+
+    std::vector< FRun > Runs;
+  };
+
+  struct FBlockBuilder
+  {
+    void OnUnknownMarkup( const FChar*, const FChar* ) NoExcept
+    {
+      ++UnknownMarkups;
+    }
+
+    template < typename PhaseType >
+    void Tokenize( const PhaseType &Phase ) NoExcept { Phase(); }
+
+    template < typename PhaseType >
+    void Build( const PhaseType &Phase ) NoExcept { Phase(); }
+
+    void AddBlock( const FChar *const Text, const int, const InteractionMarkup::FRun *const Runs, const int RunCount ) NoExcept
+    {
+      FTextBlock TextBlock;
+
+      TextBlock.Runs.reserve( RunCount ); // Exact sized, like TArray's Reserve
+
+      for( const InteractionMarkup::FRun *Iter = Runs; Iter != Runs + RunCount; ++Iter )
+      {
+        // Like MakeShared, the vector and the reference count share one allocation
+        TextBlock.Runs.push_back( { std::make_shared< const std::vector< FChar > >( Text + Iter->Offset, Text + Iter->Offset + Iter->Length ),
+                                    Iter->Markup, Iter->Parameter } );
+      }
+
+      TextBlocks.push_back( std::move( TextBlock ) );
+    }
+
+    std::vector< FTextBlock > &TextBlocks;
+
+    size_t UnknownMarkups;
+  };
+
+  // Same as UInteractionFileLoader::ParseInteractionText on a single thread, with the runs coalesced
+  std::vector< FTextBlock > Parse( const std::string &Text ) NoExcept
+  {
+    std::vector< FChar > Decoded( Text.size() );
+
+    const FChar *const DecodedEnd = Decoded.data() + InteractionMarkup::DecodeUtf8( Text.data(), Text.size(), Decoded.data() );
+
+    std::vector< FTextBlock > TextBlocks;
+
+    FBlockBuilder Builder{ TextBlocks, 0 };
+
+    InteractionMarkup::TBlockParser< FChar > Parser;
+
+    Parser.Parse( Decoded.data(), DecodedEnd, true, Builder );
+
+    return TextBlocks; // NRVO
+  }
+
+  const char *const Words[] = { "the", "village", "has", "not", "seen", "rain", "in", "weeks", "traveler", "please", "help" };
+
+  constexpr size_t WordCount = sizeof( Words ) / sizeof( *Words );
+
+  // Dialogue with no markups at all
+  std::string MakePlainText( const size_t Size ) NoExcept
+  {
+    std::mt19937 Random{ 300 };
+
+    std::string Corpus;
+
+    while( Corpus.size() < Size )
+    {
+      for( int i = 4 + static_cast< int >( Random() % 24 ); i; --i )
+      {
+        Corpus += Words[ Random() % WordCount ];
+        Corpus += ' ';
+      }
+
+      Corpus.back() = '\n';
+    }
+
+    return Corpus; // NRVO
+  }
+
+  // Every few words open and close overlapping markups, the worst case for runs per block
+  std::string MakeDenseMarkup( const size_t Size ) NoExcept
+  {
+    std::mt19937 Random{ 300 };
+
+    std::string Corpus;
+
+    while( Corpus.size() < Size )
+    {
+      for( int i = 1 + static_cast< int >( Random() % 6 ); i; --i )
+      {
+        // <b><i>A <u>B</u></b> C</i> <color=red><wave>D</wave></color>, color's value is parsed into the run's Parameter
+        Corpus += "<b><i>";
+        Corpus += Words[ Random() % WordCount ];
+        Corpus += " <u>";
+        Corpus += Words[ Random() % WordCount ];
+        Corpus += "</u></b> ";
+        Corpus += Words[ Random() % WordCount ];
+        Corpus += "</i> <color=red><wave>";
+        Corpus += Words[ Random() % WordCount ];
+        Corpus += "</wave></color> ";
+      }
+
+      Corpus.back() = '\n';
+    }
+
+    return Corpus; // NRVO
+  }
+
+  // A few huge blocks, such as a book the player can read
+  std::string MakeLongLines( const size_t Size ) NoExcept
+  {
+    std::mt19937 Random{ 300 };
+
+    std::string Corpus;
+
+    while( Corpus.size() < Size )
+    {
+      for( const size_t LineStart = Corpus.size(); Corpus.size() - LineStart < 256 * 1024; )
+      {
+        const bool Marked = Random() % 20 == 0;
+
+        if( Marked ) Corpus += "<i>";
+
+        Corpus += Words[ Random() % WordCount ];
+
+        if( Marked ) Corpus += "</i>";
+
+        Corpus += ' ';
+      }
+
+      Corpus.back() = '\n';
+    }
+
+    return Corpus; // NRVO
+  }
+
+  // Lots of one or two word blocks, such as menu options and barks
+  std::string MakeShortLines( const size_t Size ) NoExcept
+  {
+    std::mt19937 Random{ 300 };
+
+    std::string Corpus;
+
+    while( Corpus.size() < Size )
+    {
+      const bool Marked = Random() % 4 == 0;
+
+      if( Marked ) Corpus += "<b>";
+
+      Corpus += Words[ Random() % WordCount ];
+
+      if( Marked ) Corpus += "</b>";
+
+      if( Random() % 2 )
+      {
+        Corpus += ' ';
+        Corpus += Words[ Random() % WordCount ];
+      }
+
+      Corpus += '\n';
+    }
+
+    return Corpus; // NRVO
+  }
+
+  // Localized dialogue, every word is multi-byte UTF-8 so the ASCII fast path is rarely taken
+  std::string MakeLocalized( const size_t Size ) NoExcept
+  {
+    static const char *const LocalizedWords[] = { "\xD0\xB4\xD0\xB5\xD1\x80\xD0\xB5\xD0\xB2\xD0\xBD\xD1\x8F",       // деревня
+                                                  "\xE6\x9D\x91",                                                   // 村
+                                                  "\xC3\xBC" "ber",                                                 // über
+                                                  "\xE3\x81\x82\xE3\x82\x81",                                       // あめ
+                                                  "\xF0\x9F\x8C\xA7" };                                             // 🌧
+
+    std::mt19937 Random{ 300 };
+
+    std::string Corpus;
+
+    while( Corpus.size() < Size )
+    {
+      for( int i = 4 + static_cast< int >( Random() % 24 ); i; --i )
+      {
+        const bool Marked = Random() % 10 == 0;
+
+        if( Marked ) Corpus += "<b>";
+
+        Corpus += LocalizedWords[ Random() % ( sizeof( LocalizedWords ) / sizeof( *LocalizedWords ) ) ];
+
+        if( Marked ) Corpus += "</b>";
+
+        Corpus += ' ';
+      }
+
+      Corpus.back() = '\n';
+    }
+
+    return Corpus; // NRVO
+  }
+
+  void Run( const char *const Name, const std::string &Corpus ) NoExcept
+  {
+    constexpr int Iterations = 10;
+
+    double Best = 1e30; // The fastest run is the one with the least noise
+
+    size_t BlockCount = 0;
+    size_t RunCount   = 0;
+
+    for( int i = 0; i < Iterations; ++i )
+    {
+      const auto Start = std::chrono::steady_clock::now();
+
+      const std::vector< FTextBlock > TextBlocks = Parse( Corpus );
+
+      Best = std::min( Best, std::chrono::duration< double >( std::chrono::steady_clock::now() - Start ).count() );
+
+      BlockCount = TextBlocks.size();
+      RunCount   = 0;
+
+      for( const FTextBlock &Iter : TextBlocks ) RunCount += Iter.Runs.size();
+    }
+
+    // One more parse to count its allocations, the result is freed before the peak is read so only the parse is measured
+    const FAllocationStats Before = AllocationStats;
+
+    AllocationStats.Peak = AllocationStats.Current;
+
+    {
+      const std::vector< FTextBlock > TextBlocks = Parse( Corpus );
+    }
+
+    const double Allocations = static_cast< double >( AllocationStats.Count - Before.Count ) / std::max< size_t >( BlockCount, 1 );
+    const double PeakMB      = static_cast< double >( AllocationStats.Peak - Before.Current ) / ( 1024.0 * 1024.0 );
+
+    std::printf( "%-24s %10.2f ms %10.1f MB/s %10zu %10zu %12.2f %10.1f\n", Name, Best * 1000.0, Corpus.size() / Best / ( 1024.0 * 1024.0 ),
+                 BlockCount, RunCount, Allocations, PeakMB );
+  }
+}
+
+int main( const int ArgCount, const char *const *const Args ) NoExcept
+{
+  const size_t Size = static_cast< size_t >( ArgCount > 1 ? std::max( std::atoi( Args[ 1 ] ), 1 ) : 32 ) * 1024 * 1024;
+
+#if INTERACTION_SCANNER_AVX2
+  std::printf( "The scanner is using AVX2, %zu MB corpora\n", Size / ( 1024 * 1024 ) );
+#elif INTERACTION_SCANNER_SSE2
+  std::printf( "The scanner is using SSE2, %zu MB corpora\n", Size / ( 1024 * 1024 ) );
+#else
+  std::printf( "The scanner is using the scalar fallback, %zu MB corpora\n", Size / ( 1024 * 1024 ) );
+#endif
+
+  std::printf( "%-24s %13s %15s %10s %10s %12s %10s\n", "Benchmark", "Time", "Throughput", "Blocks", "Runs", "Allocs/Block", "Peak MB" );
+  std::printf( "%s\n", std::string( 100, '-' ).c_str() );
+
+  Run( "Parse/PlainText",   MakePlainText  ( Size ) );
+  Run( "Parse/DenseMarkup", MakeDenseMarkup( Size ) );
+  Run( "Parse/LongLines",   MakeLongLines  ( Size ) );
+  Run( "Parse/ShortLines",  MakeShortLines ( Size ) );
+  Run( "Parse/Localized",   MakeLocalized  ( Size ) );
+
+  return 0;
+}
@@ -0,0 +1,144 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionScannerBenchmark.cpp
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+// Measures how fast the markup delimiters can be found, without the engine.
+// Build from this folder with either:
+//   g++ -O2 -std=c++14 -I../Production InteractionScannerBenchmark.cpp -o ScannerBenchmark
+//   g++ -O2 -std=c++14 -mavx2 -I../Production InteractionScannerBenchmark.cpp -o ScannerBenchmark
+
+#include "InteractionMarkupScanner.h"
+
+// STL Includes
+#include <chrono>
+#include <cstdio>
+#include <cstring> // memchr
+#include <random>
+#include <string>
+
+namespace
+{
+  // Lines of dialogue with a markup every few words, roughly what the writers produce
+  std::string MakeCorpus( const size_t Size, const int MarkupPercent ) NoExcept
+  {
+    static const char *const Words[] = { "the", "village", "has", "not", "seen", "rain", "in", "weeks", "traveler", "please", "help" };
+    static const char *const Markups[][ 2 ] = { { "<b>", "</b>" }, { "<i>", "</i>" }, { "<u>", "</u>" }, { "<s>", "</s>" } };
+
+    std::mt19937 Random{ 300 };
+
+    std::string Corpus;
+
+    Corpus.reserve( Size + 256 );
+
+    while( Corpus.size() < Size )
+    {
+      const int WordCount = 4 + static_cast< int >( Random() % 24 );
+
+      for( int i = 0; i < WordCount; ++i )
+      {
+        const bool Marked = static_cast< int >( Random() % 100 ) < MarkupPercent;
+        const auto &Markup = Markups[ Random() % 4 ];
+
+        if( Marked ) Corpus += Markup[ 0 ];
+
+        Corpus += Words[ Random() % ( sizeof( Words ) / sizeof( *Words ) ) ];
+
+        if( Marked ) Corpus += Markup[ 1 ];
+
+        Corpus += ' ';
+      }
+
+      Corpus.back() = '\n';
+    }
+
+    return Corpus; // NRVO
+  }
+
+  // What the loader used to do, find the end of the block and then search it again for markups
+  size_t CountTwoPass( const std::string &Corpus ) NoExcept
+  {
+    size_t Count = 0;
+
+    const char *const End = Corpus.data() + Corpus.size();
+
+    for( const char *Block = Corpus.data(), *BlockEnd; ( BlockEnd = static_cast< const char* >( std::memchr( Block, '\n', End - Block ) ) ) != nullptr;
+         Block = BlockEnd + 1 )
+    {
+      ++Count;
+
+      for( const char *Iter = Block; ( Iter = static_cast< const char* >( std::memchr( Iter, '<', BlockEnd - Iter ) ) ) != nullptr; ++Iter ) ++Count;
+    }
+
+    return Count;
+  }
+
+  size_t CountScalar( const std::string &Corpus ) NoExcept
+  {
+    size_t Count = 0;
+
+    const char *const End = Corpus.data() + Corpus.size();
+
+    for( const char *Iter = Corpus.data(); ( Iter = InteractionMarkup::FindDelimiterScalar( Iter, End ) ) != End; ++Iter ) ++Count;
+
+    return Count;
+  }
+
+  size_t CountScanner( const std::string &Corpus ) NoExcept
+  {
+    size_t Count = 0;
+
+    const char *const End = Corpus.data() + Corpus.size();
+
+    InteractionMarkup::FDelimiterScanner Scanner{ End };
+
+    for( const char *Iter = Corpus.data(); ( Iter = Scanner.Next( Iter ) ) != End; ++Iter ) ++Count;
+
+    return Count;
+  }
+
+  void Run( const char *const Name, size_t( *const Count )( const std::string& ), const std::string &Corpus ) NoExcept
+  {
+    constexpr int Iterations = 20;
+
+    size_t Found = 0;
+
+    const auto Start = std::chrono::steady_clock::now();
+
+    for( int i = 0; i < Iterations; ++i ) Found += Count( Corpus );
+
+    const double Seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - Start ).count();
+
+    std::printf( "  %-14s %10.1f MB/s  (%zu delimiters)\n", Name, Corpus.size() * Iterations / Seconds / ( 1024.0 * 1024.0 ), Found / Iterations );
+  }
+}
+
+int main() NoExcept
+{
+#if INTERACTION_SCANNER_AVX2
+  std::printf( "FDelimiterScanner is using AVX2\n" );
+#elif INTERACTION_SCANNER_SSE2
+  std::printf( "FDelimiterScanner is using SSE2\n" );
+#else
+  std::printf( "FDelimiterScanner is using the scalar fallback\n" );
+#endif
+
+  for( const int MarkupPercent : { 0, 5, 25 } )
+  {
+    const std::string Corpus = MakeCorpus( 64 * 1024 * 1024, MarkupPercent );
+
+    std::printf( "64 MB corpus, %i%% of words marked up:\n", MarkupPercent );
+
+    Run( "Two pass", CountTwoPass, Corpus );
+    Run( "Scalar",   CountScalar,  Corpus );
+    Run( "Scanner",  CountScanner, Corpus );
+  }
+
+  return 0;
+}
@@ -0,0 +1,101 @@
+/*!------------------------------------------------------------------------------
+\file   LowPolySpawnScheduler.cpp
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#include "LowPolySpawnScheduler.h"
+
+// Unreal Includes
+#include "Camera/PlayerCameraManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h" // GetPlayerCameraManager
+
+// Our Includes
+#include "LowPolySpawner.h"
+
+static TAutoConsoleVariable< float > CVarFrameBudgetMs( TEXT( "Viridian.LowPolySpawner.FrameBudgetMs" ), 2.f,
+  TEXT( "How many milliseconds a frame can be spent spawning low poly meshes, 0 or less has no limit" ) );
+
+FLowPolySpawnScheduler &FLowPolySpawnScheduler::Get() NoExcept
+{
+  static FLowPolySpawnScheduler Scheduler;
+
+  return Scheduler;
+}
+
+void FLowPolySpawnScheduler::Add( ALowPolySpawner *const Spawner ) NoExcept
+{
+  Spawners.AddUnique( Spawner );
+
+  if( !( TickerHandle.IsValid() ) )
+  {
+    TickerHandle = FTicker::GetCoreTicker().AddTicker( FTickerDelegate::CreateRaw( this, &FLowPolySpawnScheduler::Tick ) );
+  }
+}
+
+void FLowPolySpawnScheduler::Remove( ALowPolySpawner *const Spawner ) NoExcept
+{
+  // The ticker is left alone, the next tick still broadcasts OnAllSpawnsFinished if this was the last one
+  Spawners.Remove( Spawner );
+}
+
+bool FLowPolySpawnScheduler::IsIdle() const NoExcept
+{
+  return Spawners.Num() == 0;
+}
+
+bool FLowPolySpawnScheduler::Tick( float ) NoExcept
+{
+  // Destroyed and streamed out spawners are dropped without finishing
+  Spawners.RemoveAll( []( const TWeakObjectPtr< ALowPolySpawner > &Iter )NoExcept->bool { return !( Iter.IsValid() ) || !( Iter->GetWorld() ); } );
+
+  { // Closest to the player first, spawners without a player (such as in the editor) keep the order they were added in
+    TMap< const ALowPolySpawner*, float > Distances;
+
+    for( const TWeakObjectPtr< ALowPolySpawner > &Iter : Spawners )
+    {
+      const APlayerCameraManager *const Camera = UGameplayStatics::GetPlayerCameraManager( Iter.Get(), 0 );
+
+      Distances.Add( Iter.Get(), Camera ? FVector::DistSquared( Camera->GetCameraLocation(), Iter->GetActorLocation() ) : 0.f );
+    }
+
+    Spawners.StableSort( [ &Distances ]( const TWeakObjectPtr< ALowPolySpawner > &Left, const TWeakObjectPtr< ALowPolySpawner > &Right )NoExcept->bool
+    {
+      return Distances[ Left.Get() ] < Distances[ Right.Get() ];
+    } );
+  }
+
+  const float BudgetMs = CVarFrameBudgetMs.GetValueOnGameThread();
+
+  const double Deadline = BudgetMs > 0.f ? FPlatformTime::Seconds() + BudgetMs / 1000.0 : TNumericLimits< double >::Max();
+
+  for( int32 i = 0; i < Spawners.Num(); )
+  {
+    ALowPolySpawner *const Spawner = Spawners[ i ].Get();
+
+    if( Spawner->ProcessSpawning( Deadline ) )
+    {
+      Spawners.RemoveAt( i, 1, false );
+
+      Spawner->OnSpawnFinished.Broadcast( Spawner );
+    }
+    else ++i;
+
+    // The spawners still waiting on traces don't take any time, so only stop once the budget is actually gone
+    if( FPlatformTime::Seconds() >= Deadline ) break;
+  }
+
+  if( Spawners.Num() ) return true;
+
+  TickerHandle.Reset(); // Returning false removes the ticker
+
+  OnAllSpawnsFinished.Broadcast();
+
+  return false;
+}
@@ -0,0 +1,52 @@
+/*!------------------------------------------------------------------------------
+\file   LowPolySpawnScheduler.h
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#pragma once
+
+// Unreal Includes
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+
+// Our Includes
+#include "Public/Utils/Macros.h"
+
+// Commonly used forward declarations
+class ALowPolySpawner;
+
+// Spreads the spawning of every ALowPolySpawner over as many frames as it takes, spending at most Viridian.LowPolySpawner.FrameBudgetMs a frame.
+// The spawners closest to the player go first, so the foliage around them shows up before the foliage across the level.
+class VIRIDIAN_API FLowPolySpawnScheduler
+{
+  public:
+    static FLowPolySpawnScheduler &Get() NoExcept;
+
+  public:
+    // The spawner's state is reset by SpawnMeshes, adding it again only keeps its place
+    void Add( ALowPolySpawner *Spawner ) NoExcept;
+
+    // Dropped without finishing, OnSpawnFinished is not broadcast for it
+    void Remove( ALowPolySpawner *Spawner ) NoExcept;
+
+    bool IsIdle() const NoExcept;
+
+  public:
+    FSimpleMulticastDelegate OnAllSpawnsFinished; // Such as to drop a loading screen
+
+  private:
+    FLowPolySpawnScheduler() NoExcept = default;
+
+    bool Tick( float DeltaTime ) NoExcept;
+
+  private:
+    TArray< TWeakObjectPtr< ALowPolySpawner > > Spawners;
+
+    FDelegateHandle TickerHandle; // Only ticking while there is something to spawn
+};
@@ -13,6 +13,9 @@
 
 // Unreal Includes
 #include "Components/InstancedStaticMeshComponent.h"
+#include "Async/ParallelFor.h"
+#include "Engine/World.h" // AsyncLineTraceByChannel, OverlapMultiByChannel
+#include "Misc/Crc.h"
 
 #if WITH_EDITOR
 #include "Components/BillboardComponent.h"
@@ -25,6 +28,7 @@
 #include "Classes/Engine/StaticMesh.h"
 
 // Our Includes
+#include "LowPolySpawnScheduler.h"
 #include "RandUtils.h" // RandomVector_InRange_FromStream
 
 #if WITH_EDITOR
@@ -83,6 +87,43 @@ static constexpr int32 RoundToMultiple( int32 Round, uint32 Multiple ) NoExcept
                                             (  Round + Multiple / 2 ) / Multiple * Multiple   ; // RVO
 }
 
+// Each candidate, and each of its retries, gets its own stream from the seed and its index instead of them all sharing one
+static int32 CandidateSeed( const int32 RandomSeed, const int32 Index, const int32 Attempt ) NoExcept
+{
+  // Murmur3's finalizer, so neighboring indices get unrelated seeds
+  const auto Mix = []( uint32 Hash )NoExcept->uint32
+  {
+    Hash ^= Hash >> 16;
+    Hash *= 0x85EBCA6Bu;
+    Hash ^= Hash >> 13;
+    Hash *= 0xC2B2AE35u;
+    Hash ^= Hash >> 16;
+
+    return Hash;
+  };
+
+  return static_cast< int32 >( Mix( Mix( Mix( static_cast< uint32 >( RandomSeed ) ) ^ static_cast< uint32 >( Index ) ) ^ static_cast< uint32 >( Attempt ) ) );
+}
+
+// Adds every transform to the Component with its render state, physics bodies and navigation updated once, instead of once for each instance
+static void AddInstancesWorldSpace( UInstancedStaticMeshComponent *const Component, const TArray< FTransform > &Transforms ) NoExcept
+{
+  if( !Component || Transforms.Num() == 0 ) return;
+
+  const FTransform ComponentTransform = Component->GetComponentTransform();
+
+  // Unregistered, adding an instance is only an array add. Registering again creates everything for all of them at once.
+  const bool WasRegistered = Component->IsRegistered();
+
+  if( WasRegistered ) Component->UnregisterComponent();
+
+  Component->PerInstanceSMData.Reserve( Component->PerInstanceSMData.Num() + Transforms.Num() );
+
+  for( const FTransform &Iter : Transforms ) Component->AddInstance( Iter.GetRelativeTransform( ComponentTransform ) );
+
+  if( WasRegistered ) Component->RegisterComponent();
+}
+
 #if WITH_EDITOR
 void ALowPolySpawner::PostEditChangeProperty( FPropertyChangedEvent &PropertyChangedEvent ) NoExcept 
 {
@@ -105,6 +146,8 @@ void ALowPolySpawner::PostEditChangeProperty( FPropertyChangedEvent &PropertyCha
 
         // We add/removed Instance Meshes, clear array
         Instances.Empty( Instances.Num() );
+
+        CancelSpawn(); // Its candidates picked from the old meshes
       }
       else // GenerateMeshes
       {
@@ -115,6 +158,8 @@ void ALowPolySpawner::PostEditChangeProperty( FPropertyChangedEvent &PropertyCha
         {
           Instances.Empty( Instances.Num() );
 
+          CancelSpawn();
+
           for( UStaticMesh *const Iter : GeneratableMeshes )
           {
             auto *const Instance = NewObject< UInstancedStaticMeshComponent >( this );
@@ -358,6 +403,41 @@ void ALowPolySpawner::PostEditChangeProperty( FPropertyChangedEvent &PropertyCha
     }
   }
 }
+
+void ALowPolySpawner::PreSave( const ITargetPlatform *const TargetPlatform ) NoExcept
+{
+  Super::PreSave( TargetPlatform );
+
+  // The ground can't be checked while cooking, it has no collision, shipping builds check it and fall back to spawning
+  if( TargetPlatform && BakedParamHash != HashSpawnParams() )
+  {
+    DebugLogType( "The LowPolySpawner '%s' has no baked meshes, or was changed since they were baked, press Generate Meshes! Shipping builds will spawn it at runtime.",
+                  Warning, *GetName() );
+  }
+}
+
+void ALowPolySpawner::BakeInstances() NoExcept
+{
+  Modify(); // So the baked meshes are saved with the level
+
+  BakedMeshes.Reset( Instances.Num() );
+
+  for( const UInstancedStaticMeshComponent *const Iter : Instances )
+  {
+    TArray< FTransform > &Transforms = BakedMeshes[ BakedMeshes.AddDefaulted() ].Transforms;
+
+    if( !Iter ) continue; // Destroyed by the editor while spawning, still takes a slot so the rest line up with the GeneratableMeshes
+
+    const int32 Num = Iter->GetInstanceCount();
+
+    Transforms.SetNumUninitialized( Num );
+
+    for( int32 i = 0; i < Num; ++i ) Iter->GetInstanceTransform( i, Transforms[ i ], true );
+  }
+
+  BakedParamHash  = HashSpawnParams();
+  BakedGroundHash = HashSpawnGround();
+}
 #else
 void ALowPolySpawner::BeginPlay() NoExcept
 {
@@ -390,186 +470,275 @@ void ALowPolySpawner::BeginPlay() NoExcept
     Instance->AttachToComponent( RootComponent, FAttachmentTransformRules::SnapToTargetIncludingScale );
   }
 
+  // Use the meshes baked in the editor if nothing they depend on has changed since
+  if( BakedMeshes.Num() == Instances.Num() && BakedParamHash == HashSpawnParams() && BakedGroundHash == HashSpawnGround() )
+  {
+    for( int32 Mesh = 0; Mesh < BakedMeshes.Num(); ++Mesh ) AddInstancesWorldSpace( Instances[ Mesh ], BakedMeshes[ Mesh ].Transforms );
+
+    OnSpawnFinished.Broadcast( this );
+
+    return;
+  }
+
+  DebugLogType( "The LowPolySpawner '%s' has no baked meshes, or they are out of date, spawning at runtime!", Log, *GetName() );
+
+  // Only queues the spawn, the scheduler spreads it over the next frames so levels with lots of spawners don't hitch
   SpawnMeshes();
 }
 #endif
 
-// Created a macro since it runs diffrent spawn code and I did not want to use function ptrs for something this small
-#define MainSpawnLoop( SpawnCode )                                                                                          \
-for( int32 i = 0; i < SpawnCount; ++i )                                                                                     \
-{                                                                                                                           \
-  for( int32 j = 0; ; ) /* Try x times, then quit */                                                                        \
-  {                                                                                                                         \
-    const FVector SpawnLoc{ URandUtils::RandomPointInBoundingBox_FromStream( ActorLoc, SpawnArea, TempStream ) };           \
-                                                                                                                            \
-    FHitResult Hit;                                                                                                         \
-                                                                                                                            \
-    if( World->LineTraceSingleByChannel( Hit, SpawnLoc, FVector{ SpawnLoc.X, SpawnLoc.Y, EndZ }, ECC_WorldStatic,           \
-                                         CollisionParams, FCollisionResponseParams::DefaultResponseParam ) )                \
-    {                                                                                                                       \
-      SpawnCode                                                                                                             \
-    }                                                                                                                       \
-                                                                                                                            \
-    if( ++j >= RetryCount )                                                                                                 \
-    {                                                                                                                       \
-      DebugLogType( "A LowPolySpawner was unable to register a hit, to spawn a mesh, after trying %i times!", Warning, j ); \
-                                                                                                                            \
-      break;                                                                                                                \
-    }                                                                                                                       \
-  }                                                                                                                         \
-}                                                                                                                           \
-
-#define SpawnWithOutScale                                                                   \
-Instances[ UKismetMathLibrary::RandomIntegerInRangeFromStream( 0, Num, TempStream ) ]->     \
-  AddInstanceWorldSpace( { UKismetMathLibrary::MakeRotFromX( Hit.Normal ), Hit.Location } ) \
-
-#define SpawnWithScale                                                                                       \
-Instances[ UKismetMathLibrary::RandomIntegerInRangeFromStream( 0, Num, TempStream ) ]->                      \
-  AddInstanceWorldSpace( { UKismetMathLibrary::MakeRotFromX( Hit.Normal ), Hit.Location,                     \
-                           URandUtils::RandomVector_InRange_FromStream( MinScale, MaxScale, TempStream ) } ) \
+// Everything that changes where the meshes spawn, other than the ground
+uint32 ALowPolySpawner::HashSpawnParams() const NoExcept
+{
+  uint32 Hash = 0;
 
-void ALowPolySpawner::SpawnMeshes() NoExcept
+  const auto Add = [ &Hash ]( const void *const Data, const int32 Size )NoExcept->void { Hash = FCrc::MemCrc32( Data, Size, Hash ); };
+
+  const FVector Location = GetActorLocation();
+
+  Add( &Location,           sizeof( Location ) );
+  Add( &SpawnArea,          sizeof( SpawnArea ) );
+  Add( &SpawnCount,         sizeof( SpawnCount ) );
+  Add( &AllowGroundOverlap, sizeof( AllowGroundOverlap ) );
+  Add( &RandomSeed,         sizeof( RandomSeed ) );
+  Add( &RandomScale,        sizeof( RandomScale ) );
+  Add( &MinScale,           sizeof( MinScale ) );
+  Add( &MaxScale,           sizeof( MaxScale ) );
+  Add( &RetryCount,         sizeof( RetryCount ) );
+
+  for( const UStaticMesh *const Iter : GeneratableMeshes )
+  {
+    Hash = FCrc::StrCrc32( Iter ? *( Iter->GetPathName() ) : TEXT( "None" ), Hash );
+  }
+
+  return Hash; // NRVO
+}
+
+// Everything the traces could hit. Needs the world's collision, so it can't be done while cooking.
+uint32 ALowPolySpawner::HashSpawnGround() const NoExcept
 {
-  // INITIALIZING const vars
+  TArray< FOverlapResult > Overlaps;
 
-  TArray< TEnumAsByte< EObjectTypeQuery > > CollidableObjects;
+  // By object type, a channel query would also return anything that only blocks or overlaps the channel, such as pawns
+  GetWorld()->OverlapMultiByObjectType( Overlaps, GetActorLocation(), FQuat::Identity, FCollisionObjectQueryParams{ ECC_WorldStatic },
+                                        FCollisionShape::MakeBox( SpawnArea ), FCollisionQueryParams{ FName{ "LPS" }, false, this } );
 
-  CollidableObjects.Emplace( ECC_WorldStatic );
+  TArray< uint32 > Hashes; // The overlaps are in no particular order, so they are sorted before being combined
 
-  UWorld *const World = GetWorld();
+  Hashes.Reserve( Overlaps.Num() );
 
-  const FCollisionQueryParams CollisionParams{ FName{ "LPS" }, false, this }; // Custom params to not overlap with ourselves
+  for( const FOverlapResult &Iter : Overlaps )
+  {
+    const UPrimitiveComponent *const Component = Iter.GetComponent();
 
+    // Other spawners' meshes may not be spawned yet, and anything that can move would throw the bake away every time it does
+    if( !Component || Component->Mobility != EComponentMobility::Static || Cast< ALowPolySpawner >( Component->GetOwner() ) ) continue;
 
-  const Size_T Num = Instances.Num() - 1; // Sub 1, we use Num to index into the array
+    // Rounded to a tenth, so tiny floating point differences between the editor and shipping don't throw the bake away
+    const FIntVector Rounded[] = { FIntVector{ Component->GetComponentLocation() * 10.f },
+                                   FIntVector{ Component->GetComponentRotation().Euler() * 10.f },
+                                   FIntVector{ Component->GetComponentScale() * 10.f },
+                                   FIntVector{ Component->Bounds.BoxExtent * 10.f } }; // Changes with the mesh, or the landscape's height
 
-  const FRandomStream TempStream{ RandomSeed };
+    Hashes.Emplace( FCrc::MemCrc32( Rounded, sizeof( Rounded ), FCrc::StrCrc32( *( Component->GetPathName() ) ) ) );
+  }
 
-  const FVector &ActorLoc = GetActorLocation();
+  Hashes.Sort();
+
+  return FCrc::MemCrc32( Hashes.GetData(), Hashes.Num() * sizeof( uint32 ) ); // RVO
+}
+
+void ALowPolySpawner::CancelSpawn() NoExcept
+{
+  // Anything still in flight belongs to the cancelled spawn
+  ++SpawnGeneration;
 
-  //-- INITIALIZING const vars
-  ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  FLowPolySpawnScheduler::Get().Remove( this ); // Otherwise the next tick would see nothing left and say it finished
 
-  // One dir                    = rand point, move in dir
-  // Two plus dir, without gaps = rand point, move in rand dir on blended axes
-  // Two plus dir, with gaps    = rand point, move in rand dir on non-blended axis
+  PendingTraces = 0;
+  NextCandidate = 0;
 
-  // Generate Random 3D vector based on XYZ angle, XY use actual angle, Z uses range from -1 to 1 (if both pos and neg)
-  // Pos X to Pos Y = 0->90, Pos XY to Neg X = 0->180, Pos X to Neg YX = (-180)->0, Pos XY to Neg XY = 0->360
-  // Pos Z = 0->1, Neg Z = (-1)->0, Pos Z to Neg Z = (-1)->1
-  // x = sqrt( 1-Z^2 ) * cos( Yaw ), y = sqrt( 1-Z^2 ) * sin( Yaw ) z = Z
+  Candidates.Reset();
+  TraceResults.Reset();
 
-  /*int32 Yaw;
-  int32 Pitch;
+  FinalTransforms.Reset();
 
-  // TODO: Add in new angle offsets and inverts
-  if( SpawnAngleYaw )
+  NextFinalMesh = 0;
+}
+
+void ALowPolySpawner::SpawnMeshes() NoExcept
+{
+  CancelSpawn(); // The last spawn's meshes were cleared
+
+  if( Instances.Num() == 0 ) return;
+
+  TraceDelegate = FTraceDelegate::CreateUObject( this, &ALowPolySpawner::OnTraceDone, SpawnGeneration );
+
+  TraceParams = FCollisionQueryParams{ FName{ "LPS" }, false, this }; // Custom params to not overlap with ourselves
+
+  SpawnOrigin = GetActorLocation();
+
+  // Every candidate only uses its own stream, so the chunks can run on any number of threads and still come out the same
+  Candidates.SetNumUninitialized( SpawnCount );
+
+  static constexpr int32 ChunkSize = 1024;
+
+  ParallelFor( ( SpawnCount + ChunkSize - 1 ) / ChunkSize, [ this ]( const int32 Chunk )NoExcept->void
   {
-    if( SpawnAnglePitch )
+    for( int32 i = Chunk * ChunkSize, End = FMath::Min( i + ChunkSize, Candidates.Num() ); i < End; ++i )
     {
-      if( SpawnAngleYaw > 0 )
-      {
-        Yaw = UKismetMathLibrary::RandomIntegerInRangeFromStream( 0, SpawnAngleYaw, TempStream );
-      }
-      else
-      {
-        Yaw = UKismetMathLibrary::RandomIntegerInRangeFromStream( SpawnAngleYaw, 0, TempStream );
-      }
+      const FRandomStream Stream{ CandidateSeed( RandomSeed, i, 0 ) };
 
-      // Convert to -1 -> 1
-      if( SpawnAnglePitch > 0 )
-      {
-        // If larger, we are adding negative
-        if( SpawnAnglePitch > 180 )
-        {
-          Pitch = UKismetMathLibrary::RandomIntegerInRangeFromStream( ( SpawnAnglePitch - 180 ) / -180, 1, TempStream );
-        }
-        else
-        {
-          Pitch = UKismetMathLibrary::RandomIntegerInRangeFromStream( 0, SpawnAnglePitch / 180, TempStream );
-        }
-      }
-      else
-      {
-        // If larger, we are adding positive
-        if( SpawnAnglePitch < -180 )
-        {
-          Pitch = UKismetMathLibrary::RandomIntegerInRangeFromStream( -1, ( SpawnAnglePitch + 180 ) / -180, TempStream );
-        }
-        else
-        {
-          Pitch = UKismetMathLibrary::RandomIntegerInRangeFromStream( SpawnAnglePitch / 180.f, 0, TempStream );
-        }
-      }
-    }
-    else 
-    {
-      Pitch = 0;
+      FLowPolyCandidate &Candidate = Candidates[ i ];
 
-      if( SpawnAngleYaw > 0 )
-      {
-        Yaw = UKismetMathLibrary::RandomIntegerInRangeFromStream( 0, SpawnAngleYaw, TempStream );
-      }
-      else
-      {
-        Yaw = UKismetMathLibrary::RandomIntegerInRangeFromStream( SpawnAngleYaw, 0, TempStream );
-      }
+      Candidate.Mesh  = UKismetMathLibrary::RandomIntegerInRangeFromStream( 0, Instances.Num() - 1, Stream );
+      Candidate.Scale = RandomScale ? URandUtils::RandomVector_InRange_FromStream( MinScale, MaxScale, Stream ) : FVector{ 1.f };
+      Candidate.Point = URandUtils::RandomPointInBoundingBox_FromStream( SpawnOrigin, SpawnArea, Stream );
+
+      Candidate.Attempts = 0;
+      Candidate.Hit      = false;
     }
-  }
-  else 
+  } );
+
+  // The traces are sent, and the meshes added, as the scheduler has time for them
+  FLowPolySpawnScheduler::Get().Add( this );
+}
+
+bool ALowPolySpawner::ProcessSpawning( const double Deadline ) NoExcept
+{
+  // Every result is worth at least one mesh or retry, always handle one so a tiny budget still finishes
+  int32 Handled = 0;
+
+  for( const int32 Num = TraceResults.Num(); Handled < Num; )
   {
-    Yaw = 0;
+    const FLowPolyTraceResult &Result = TraceResults[ Handled++ ];
 
-    if( SpawnAnglePitch > 0 )
+    FLowPolyCandidate &Candidate = Candidates[ Result.Candidate ];
+
+    if( Result.Hit )
     {
-      Pitch = UKismetMathLibrary::RandomIntegerInRangeFromStream( 0, SpawnAnglePitch, TempStream );
+      Candidate.Hit    = true;
+      Candidate.Point  = Result.Location;
+      Candidate.Normal = Result.Normal;
     }
-    else if( SpawnAnglePitch < 0 )
+    else if( Candidate.Attempts < RetryCount ) // Try x times, then quit
     {
-      Pitch = UKismetMathLibrary::RandomIntegerInRangeFromStream( SpawnAnglePitch, 0, TempStream );
+      RequestTrace( Result.Candidate );
     }
-    else Pitch = 0;
-  }*/
+    else DebugLogType( "A LowPolySpawner was unable to register a hit, to spawn a mesh, after trying %i times!", Warning, Candidate.Attempts );
 
-  // TODO: Replace with dynamic angle code
-  const float EndZ = ActorLoc.Z - SpawnArea.Z;
+    if( FPlatformTime::Seconds() >= Deadline ) break;
+  }
 
-  // TODO: Add option for no instance mesh overlaps
-  if( RandomScale )
+  TraceResults.RemoveAt( 0, Handled, false );
+
+  // Start on the next meshes, the results that are waiting still count against the batch since they may need a retry
+  while( NextCandidate < Candidates.Num() && PendingTraces + TraceResults.Num() < TraceBatchSize && FPlatformTime::Seconds() < Deadline )
   {
-    if( AllowGroundOverlap )
+    RequestTrace( NextCandidate++ );
+  }
+
+  if( IsTracing() ) return false;
+
+  if( FinalTransforms.Num() == 0 )
+  {
+    if( Candidates.Num() == 0 ) return true; // A SpawnCount of 0, there is nothing to add or bake
+
+    // Added in candidate order, so the instances are the same no matter what order the traces came back in
+    FinalTransforms.SetNum( Instances.Num() );
+
     {
-      MainSpawnLoop(
-        // TODO: Add option to rotate the scale based on the object's rotation.
-        //       So if the object rotates upword, but normally faces towards the x axis, z will scale it upwards instead of x.
-        SpawnWithScale; break;
-      )
+      TArray< int32 > Counts;
+
+      Counts.SetNumZeroed( Instances.Num() );
+
+      for( const FLowPolyCandidate &Iter : Candidates )
+      {
+        if( Iter.Hit && Iter.Mesh < Instances.Num() ) ++Counts[ Iter.Mesh ];
+      }
+
+      for( int32 Mesh = 0; Mesh < Instances.Num(); ++Mesh ) FinalTransforms[ Mesh ].Reserve( Counts[ Mesh ] );
     }
-    else
+
+    // TODO: Add option for no instance mesh overlaps
+    // TODO: Add option to rotate the scale based on the object's rotation.
+    //       So if the object rotates upword, but normally faces towards the x axis, z will scale it upwards instead of x.
+    for( const FLowPolyCandidate &Iter : Candidates )
     {
-      MainSpawnLoop(
-        // TODO: Should we re-generate the vector or just move it up?
-        if( !( Hit.bStartPenetrating ) ) // If we did not start the trace inside an object
-        {
-          SpawnWithScale; break;
-        }
-      )
+      if( Iter.Hit && Iter.Mesh < Instances.Num() )
+      {
+        FinalTransforms[ Iter.Mesh ].Emplace( UKismetMathLibrary::MakeRotFromX( Iter.Normal ), Iter.Point, Iter.Scale );
+      }
     }
+
+    Candidates.Empty();
+
+    NextCandidate = 0;
+    NextFinalMesh = 0;
+
+    if( FPlatformTime::Seconds() >= Deadline ) return false; // The components are added next frame
   }
-  else if( AllowGroundOverlap )
+
+  // Re-registering a component with thousands of instances can take a frame on its own, so only one is added before checking the Deadline again
+  do
   {
-    MainSpawnLoop( SpawnWithOutScale; break; );
+    // The editor can destroy a component out from under us, AddInstancesWorldSpace skips it
+    if( NextFinalMesh < Instances.Num() ) AddInstancesWorldSpace( Instances[ NextFinalMesh ], FinalTransforms[ NextFinalMesh ] );
+
+    ++NextFinalMesh;
   }
-  else
+  while( NextFinalMesh < FinalTransforms.Num() && FPlatformTime::Seconds() < Deadline );
+
+  if( NextFinalMesh < FinalTransforms.Num() ) return false;
+
+  FinalTransforms.Empty();
+
+  NextFinalMesh = 0;
+
+#if WITH_EDITOR
+  if( GetWorld()->WorldType == EWorldType::Editor ) BakeInstances();
+#endif
+
+  return true;
+}
+
+void ALowPolySpawner::RequestTrace( const int32 Index ) NoExcept
+{
+  FLowPolyCandidate &Candidate = Candidates[ Index ];
+
+  // The first point was made with the candidate, each retry gets a stream of its own
+  const FVector SpawnLoc = Candidate.Attempts ? URandUtils::RandomPointInBoundingBox_FromStream( SpawnOrigin, SpawnArea,
+                                                                                                 FRandomStream{ CandidateSeed( RandomSeed, Index, Candidate.Attempts ) } )
+                                              : Candidate.Point;
+
+  ++( Candidate.Attempts );
+
+  // TODO: Replace with dynamic angle code
+  const float EndZ = SpawnOrigin.Z - SpawnArea.Z;
+
+  GetWorld()->AsyncLineTraceByChannel( EAsyncTraceType::Single, SpawnLoc, FVector{ SpawnLoc.X, SpawnLoc.Y, EndZ }, ECC_WorldStatic, TraceParams,
+                                       FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, static_cast< uint32 >( Index ) );
+
+  ++PendingTraces;
+}
+
+// Called on the game thread the frame after the trace was sent, the result waits for ProcessSpawning
+void ALowPolySpawner::OnTraceDone( const FTraceHandle&, FTraceDatum &Datum, const uint32 Generation ) NoExcept
+{
+  if( Generation != SpawnGeneration ) return; // Re-generated while this was in flight
+
+  --PendingTraces;
+
+  const FHitResult *const Hit = Datum.OutHits.Num() ? &( Datum.OutHits[ 0 ] ) : nullptr;
+
+  const int32 Candidate = static_cast< int32 >( Datum.UserData );
+
+  // TODO: Should we re-generate the vector or just move it up?
+  if( Hit && Hit->bBlockingHit && ( AllowGroundOverlap || !( Hit->bStartPenetrating ) ) ) // Don't start the trace inside an object if not allowed
   {
-    MainSpawnLoop( 
-      // TODO: Should we re-generate the vector or just move it up?
-      if( !( Hit.bStartPenetrating ) ) // If we did not start the trace inside an object
-      {
-        SpawnWithOutScale; break;
-      }
-    )
+    TraceResults.Add( { Hit->Location, Hit->Normal, Candidate, true } );
   }
+  else TraceResults.Add( { FVector::ZeroVector, FVector::ZeroVector, Candidate, false } );
 }
 
 // BUG: Currently stretches scale
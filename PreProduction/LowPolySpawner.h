@@ -16,6 +16,7 @@
 
 // Unreal Includes
 #include "GameFramework/Actor.h"
+#include "WorldCollision.h" // FTraceDelegate, FTraceDatum
 
 // Our Includes
 #include "Public/Utils/Macros.h"
@@ -28,6 +29,42 @@
 // Commonly used forward declarations
 class UInstancedStaticMeshComponent;
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam( FLowPolySpawnFinished, class ALowPolySpawner*, Spawner );
+
+// One of the SpawnCount meshes, its mesh, scale and first point are made up front from its own random stream
+struct FLowPolyCandidate
+{
+  FVector Point; // Where the first trace starts, then where the mesh goes once one hits
+  FVector Normal;
+  FVector Scale;
+
+  int32 Mesh;
+  int32 Attempts; // How many traces were sent
+
+  bool Hit;
+};
+
+// A trace that came back, waiting for the scheduler to have time to spawn its mesh or retry it
+struct FLowPolyTraceResult
+{
+  FVector Location;
+  FVector Normal;
+
+  int32 Candidate;
+
+  bool Hit; // False if it missed, or started inside an object when that is not allowed
+};
+
+// The transforms of every instance of one of the GeneratableMeshes, baked in the editor so shipping builds don't have to trace for them
+USTRUCT()
+struct FLowPolyBakedMesh
+{
+  GENERATED_BODY()
+
+  UPROPERTY()
+  TArray< FTransform > Transforms; // World space
+};
+
 UCLASS()
 class VIRIDIAN_API ALowPolySpawner : public AActor
 {
@@ -39,10 +76,24 @@ class VIRIDIAN_API ALowPolySpawner : public AActor
   public:
 #if WITH_EDITOR
     void PostEditChangeProperty( struct FPropertyChangedEvent &PropertyChangedEvent ) NoExcept override;
+
+    void PreSave( const class ITargetPlatform *TargetPlatform ) NoExcept override;
 #else
     void BeginPlay() NoExcept override;
 #endif
 
+  public:
+    // Spawns for up to Deadline (in FPlatformTime::Seconds), returns true once every mesh is spawned. Only the FLowPolySpawnScheduler should call this.
+    bool ProcessSpawning( double Deadline ) NoExcept;
+
+    UFUNCTION( BlueprintPure, Category = "Low Poly Spawner" )
+    bool IsSpawning() const NoExcept { return IsTracing() || NextFinalMesh < FinalTransforms.Num(); }
+
+  public:
+    // Broadcast once every mesh from the last spawn has been added
+    UPROPERTY( BlueprintAssignable, Category = "Low Poly Spawner" )
+    FLowPolySpawnFinished OnSpawnFinished;
+
   // Default Variables
   public:
     // The mesh types to randomly spawn
@@ -125,14 +176,61 @@ class VIRIDIAN_API ALowPolySpawner : public AActor
     UPROPERTY( EditAnywhere, BlueprintReadOnly, Category = "Low Poly Spawner | Advanced", meta = ( ClampMin = 0 ) )
     int32 RetryCount = 100;
 
+    // How many raycasts can be waiting on results at once. Results come back the frame after they are sent, so this is also the most that can come back a frame
+    UPROPERTY( EditAnywhere, BlueprintReadOnly, Category = "Low Poly Spawner | Advanced", meta = ( ClampMin = 1 ) )
+    int32 TraceBatchSize = 256;
+
   private:
     void SpawnMeshes() NoExcept;
+    void CancelSpawn() NoExcept;
+    void RequestTrace( int32 Index ) NoExcept;
+    bool IsTracing() const NoExcept { return NextCandidate < Candidates.Num() || PendingTraces || TraceResults.Num(); }
+    void OnTraceDone( const FTraceHandle &Handle, FTraceDatum &Datum, uint32 Generation ) NoExcept;
     FTransform GenerateTransform( float Rot, bool IsYaw ) const NoExcept;
 
+    uint32 HashSpawnParams() const NoExcept;
+    uint32 HashSpawnGround() const NoExcept;
+
+#if WITH_EDITOR
+    void BakeInstances() NoExcept; // Called once a spawn in the editor finishes
+#endif
+
   private:
     UPROPERTY()
     TArray< UInstancedStaticMeshComponent* > Instances; // TODO: Possibly add ability for each mesh instance to have its own options
 
+  // Baked Instances, shipping builds load these instead of spawning if both hashes still match
+  private:
+    UPROPERTY()
+    TArray< FLowPolyBakedMesh > BakedMeshes; // One for each of the GeneratableMeshes
+
+    UPROPERTY()
+    uint32 BakedParamHash = 0;
+
+    UPROPERTY()
+    uint32 BakedGroundHash = 0;
+
+  // Async Spawning, the traces are sent and the meshes are added by ProcessSpawning, OnTraceDone only queues the results
+  private:
+    FTraceDelegate TraceDelegate; // Carries the generation it was made for
+
+    FCollisionQueryParams TraceParams;
+
+    FVector SpawnOrigin = FVector::ZeroVector; // Where the actor was when spawning started
+
+    TArray< FLowPolyCandidate > Candidates; // The meshes are added in this order once they have all been traced
+
+    int32 NextCandidate = 0; // The first that has not sent a trace yet
+    int32 PendingTraces = 0;
+
+    TArray< FLowPolyTraceResult > TraceResults;
+
+    uint32 SpawnGeneration = 0; // Bumped by every SpawnMeshes, so results from a previous spawn are thrown away
+
+    TArray< TArray< FTransform > > FinalTransforms; // For each of the Instances, made once every trace is done and added a component at a time
+
+    int32 NextFinalMesh = 0; // The first of the FinalTransforms that has not been added yet
+
 #if WITH_EDITORONLY_DATA
   private:
     UPROPERTY()
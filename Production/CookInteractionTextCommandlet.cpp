@@ -0,0 +1,207 @@
+/*!------------------------------------------------------------------------------
+\file   CookInteractionTextCommandlet.cpp
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#include "Public/InteractionText/CookInteractionTextCommandlet.h"
+
+// Unreal Includes
+#include "AssetRegistryModule.h"
+#include "Engine/Blueprint.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Kismet/KismetSystemLibrary.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+
+#if WITH_EDITOR
+#include "EdGraph/EdGraphPin.h"
+#include "K2Node_CallFunction.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+#endif
+
+// Our Includes
+#include "Public/InteractionText/CookedInteractionFile.h"
+#include "Public/InteractionText/InteractionFileLoader.h"
+#include "Public/InteractionText/InteractionTextArchive.h"
+#include "Public/InteractionText/InteractionTextPrefetch.h"
+
+UCookInteractionTextCommandlet::UCookInteractionTextCommandlet() NoExcept
+{
+  IsClient        = false;
+  IsServer        = false;
+  IsEditor        = true;
+  LogToConsole    = true;
+  ShowErrorCount  = true;
+}
+
+#if WITH_EDITOR
+namespace
+{
+  // Adds the FileName of every UInteractionFileLoader call in the Blueprint that is typed into the node instead of wired in
+  void AddBlueprintFileNames( const UBlueprint *const Blueprint, TSet< FName > &FileNames ) NoExcept
+  {
+    TArray< UK2Node_CallFunction* > Nodes;
+
+    FBlueprintEditorUtils::GetAllNodesOfClass( Blueprint, Nodes );
+
+    for( const UK2Node_CallFunction *const Iter : Nodes )
+    {
+      const UFunction *const Function = Iter->GetTargetFunction();
+
+      if( !Function || Function->GetOwnerClass() != UInteractionFileLoader::StaticClass() ) continue;
+
+      const UEdGraphPin *const Pin = Iter->FindPin( TEXT( "FileName" ) );
+
+      if( Pin && Pin->LinkedTo.Num() == 0 ) FileNames.Add( FName{ *( Pin->DefaultValue ) } );
+    }
+  }
+}
+#endif
+
+int32 UCookInteractionTextCommandlet::Main( const FString &Params ) NoExcept
+{
+  const FString SourceDirectory = UKismetSystemLibrary::GetProjectContentDirectory() + "InteractionTextFiles/";
+
+  TArray< FString > FileNames;
+
+  IFileManager::Get().FindFiles( FileNames, *SourceDirectory, nullptr ); // Only the files, the Cooked folder is skipped
+
+  int32 FailedCount = 0;
+
+  const bool WriteArchive = FParse::Param( *Params, TEXT( "archive" ) );
+
+  TMap< FName, TArray< uint8 > > CookedFiles; // Only kept when writing the archive
+
+  for( const FString &Iter : FileNames )
+  {
+    const FName FileName{ *Iter };
+
+    TArray< uint8 > FullText;
+
+    if( !( FFileHelper::LoadFileToArray( FullText, *( SourceDirectory + Iter ) ) ) )
+    {
+      DebugLogType( "Unable to open file '%s'!", Error, *Iter );
+
+      ++FailedCount;
+
+      continue;
+    }
+
+    // Uses the exact same parser as the runtime, so cooked and uncooked files always match
+    const TArray< FInteractionText > TextBlocks = UInteractionFileLoader::ParseInteractionText( reinterpret_cast< const char* >( FullText.GetData() ),
+                                                                                                 FullText.Num(), FileName );
+
+    if( !( FCookedInteractionFile::Write( FCookedInteractionFile::GetCookedPath( FileName ), TextBlocks ) ) )
+    {
+      DebugLogType( "Unable to write the cooked version of '%s'!", Error, *Iter );
+
+      ++FailedCount;
+    }
+
+    if( WriteArchive ) FCookedInteractionFile::Serialize( TextBlocks, CookedFiles.Add( FileName ) );
+  }
+
+  if( WriteArchive && !( FInteractionTextArchive::Write( FInteractionTextArchive::GetArchivePath(), CookedFiles ) ) )
+  {
+    DebugLogType( "Unable to write the interaction text archive!", Error );
+
+    ++FailedCount;
+  }
+
+  DebugLogType( "Cooked %i of %i interaction files.", Display, FileNames.Num() - FailedCount, FileNames.Num() );
+
+  if( FParse::Param( *Params, TEXT( "manifests" ) ) ) FailedCount += WriteManifests();
+
+  return FailedCount;
+}
+
+int32 UCookInteractionTextCommandlet::WriteManifests() NoExcept
+{
+  IAssetRegistry &AssetRegistry = FModuleManager::LoadModuleChecked< FAssetRegistryModule >( TEXT( "AssetRegistry" ) ).Get();
+
+  AssetRegistry.SearchAllAssets( true ); // Commandlets don't wait for the registry to finish on its own
+
+  TArray< FAssetData > Maps;
+
+  AssetRegistry.GetAssetsByClass( UWorld::StaticClass()->GetFName(), Maps );
+
+  int32 FailedCount = 0;
+
+  for( const FAssetData &Iter : Maps )
+  {
+    UPackage *const Package = LoadPackage( nullptr, *( Iter.PackageName.ToString() ), LOAD_None );
+
+    if( !Package )
+    {
+      DebugLogType( "Unable to load the map '%s'!", Error, *( Iter.PackageName.ToString() ) );
+
+      ++FailedCount;
+
+      continue;
+    }
+
+    TSet< FName > FileNames;
+
+    TSet< const UBlueprint* > Blueprints; // The level's Blueprint, and the Blueprints of everything placed in it
+
+    // Every actor and component in the map, checking all of their properties tagged with meta = ( InteractionFile )
+    ForEachObjectWithOuter( Package, [ &FileNames, &Blueprints ]( UObject *const Object )NoExcept->void
+    {
+#if WITH_EDITOR
+      if( const UBlueprint *const Blueprint = Cast< UBlueprint >( Object ) ) Blueprints.Add( Blueprint );
+
+      // Parent Blueprints can make the calls too
+      for( const UClass *Class = Object->GetClass(); Class; Class = Class->GetSuperClass() )
+      {
+        if( const UBlueprint *const Blueprint = Cast< UBlueprint >( Class->ClassGeneratedBy ) ) Blueprints.Add( Blueprint );
+      }
+#endif
+
+      for( TFieldIterator< UProperty > Property{ Object->GetClass() }; Property; ++Property )
+      {
+        if( !( Property->HasMetaData( FInteractionTextPrefetch::MetaDataName ) ) ) continue;
+
+        if( const UNameProperty *const NameProperty = Cast< UNameProperty >( *Property ) )
+        {
+          FileNames.Add( NameProperty->GetPropertyValue_InContainer( Object ) );
+        }
+        else if( const UArrayProperty *const ArrayProperty = Cast< UArrayProperty >( *Property ) )
+        {
+          if( !( ArrayProperty->Inner->IsA< UNameProperty >() ) ) continue;
+
+          FScriptArrayHelper Array{ ArrayProperty, ArrayProperty->ContainerPtrToValuePtr< void >( Object ) };
+
+          for( int32 i = 0; i < Array.Num(); ++i ) FileNames.Add( *reinterpret_cast< const FName* >( Array.GetRawPtr( i ) ) );
+        }
+      }
+    }, true );
+
+#if WITH_EDITOR
+    // Most files are named straight on a Load Interaction File node, not in a property
+    for( const UBlueprint *const Blueprint : Blueprints ) AddBlueprintFileNames( Blueprint, FileNames );
+#endif
+
+    FileNames.Remove( NAME_None );
+
+    // By the full package path, maps in different folders can share a name
+    if( !( FInteractionTextPrefetch::WriteManifest( Iter.PackageName, FileNames.Array() ) ) )
+    {
+      DebugLogType( "Unable to write the interaction manifest for '%s'!", Error, *( Iter.PackageName.ToString() ) );
+
+      ++FailedCount;
+    }
+
+    CollectGarbage( RF_NoFlags ); // Maps are large, don't keep them all loaded
+  }
+
+  DebugLogType( "Wrote interaction manifests for %i of %i maps.", Display, Maps.Num() - FailedCount, Maps.Num() );
+
+  return FailedCount;
+}
@@ -0,0 +1,45 @@
+/*!------------------------------------------------------------------------------
+\file   CookInteractionTextCommandlet.h
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#pragma once
+
+// This must be first
+#include "ObjectMacros.h"
+
+// Unreal Includes
+#include "Commandlets/Commandlet.h"
+
+// Our Includes
+#include "Public/Utils/Macros.h"
+
+// STL Includes
+
+// This must be last
+#include "CookInteractionTextCommandlet.generated.h"
+
+// Parses every file in Content/InteractionTextFiles/ and writes the cooked version into InteractionTextFiles/Cooked/.
+// Run it before packaging: UE4Editor-Cmd.exe Viridian.uproject -run=CookInteractionText
+// Add -archive to also pack every file into InteractionTextFiles/Cooked/InteractionText.archive
+// Add -manifests to also write which files each map uses, so they are prefetched when it loads (see FInteractionTextPrefetch)
+UCLASS()
+class VIRIDIAN_API UCookInteractionTextCommandlet : public UCommandlet
+{
+  GENERATED_BODY()
+
+  public:
+    UCookInteractionTextCommandlet() NoExcept;
+
+  public:
+    int32 Main( const FString &Params ) NoExcept override;
+
+  private:
+    int32 WriteManifests() NoExcept; // Returns how many maps failed
+};
@@ -0,0 +1,239 @@
+/*!------------------------------------------------------------------------------
+\file   CookedInteractionFile.cpp
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#include "Public/InteractionText/CookedInteractionFile.h"
+
+// Unreal Includes
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Kismet/KismetSystemLibrary.h"
+#include "Misc/FileHelper.h"
+
+FCookedInteractionFile::FCookedInteractionFile() NoExcept {}
+
+FCookedInteractionFile::~FCookedInteractionFile() NoExcept
+{
+  MappedRegion.Reset(); // The region has to go before the file it maps
+  MappedFile.Reset();
+}
+
+bool FCookedInteractionFile::Open( const FName FileName ) NoExcept
+{
+  if( !( IsCooked( FileName ) ) ) return false; // The caller will parse the markup instead
+
+  MappedFile.Reset( FPlatformFileManager::Get().GetPlatformFile().OpenMapped( *GetCookedPath( FileName ) ) );
+
+  if( !MappedFile ) return false;
+
+  MappedRegion.Reset( MappedFile->MapRegion( 0, MappedFile->GetFileSize() ) );
+
+  DebugAssert( !MappedRegion, "Unable to map the cooked interaction file '%s'!", return false, *GetCookedPath( FileName ) )
+
+  if( Open( MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize(), *GetCookedPath( FileName ) ) ) return true;
+
+  MappedRegion.Reset(); // The caller parses the markup instead, so don't keep the mapping
+  MappedFile.Reset();
+
+  return false;
+}
+
+bool FCookedInteractionFile::Open( const uint8 *const Data, const int64 Size, const TCHAR *const DebugName ) NoExcept
+{
+  DebugAssert( Size < static_cast< int64 >( sizeof( FHeader ) ), "The cooked interaction file '%s' is corrupt!", return false, DebugName )
+
+  if( !( IsHeaderValid( *reinterpret_cast< const FHeader* >( Data ), Size, DebugName ) ) ) return false;
+
+  Header = reinterpret_cast< const FHeader* >( Data );
+
+  Blocks = reinterpret_cast< const FBlock* >( Header + 1 );
+  Runs   = reinterpret_cast< const FRun*   >( Blocks + Header->BlockCount );
+  Chars  = reinterpret_cast< const TCHAR*  >( Runs   + Header->RunCount );
+
+  // Blocks are read in place, so every offset is checked once here instead of on every read. Only the index is touched, not the text.
+  for( const FBlock *Block = Blocks; Block != Blocks + Header->BlockCount; ++Block )
+  {
+    DebugAssert( !( IsBlockValid( *Header, *Block ) ) || !( AreRunsValid( *Block, Runs + Block->FirstRun ) ),
+                 "The cooked interaction file '%s' has a block or run out of bounds!", Header = nullptr; return false, DebugName )
+  }
+
+  return true;
+}
+
+bool FCookedInteractionFile::IsHeaderValid( const FHeader &FileHeader, const int64 Size, const TCHAR *const DebugName ) NoExcept
+{
+  // Anything that does not match is treated as not cooked, so the markup gets parsed instead
+  if( FileHeader.Magic != Magic || FileHeader.Version != Version || FileHeader.CharSize != sizeof( TCHAR ) )
+  {
+    DebugLogType( "The cooked interaction file '%s' is out of date, re-run the CookInteractionText commandlet!", Warning, DebugName );
+
+    return false;
+  }
+
+  const int64 ExpectedSize = sizeof( FHeader ) + FileHeader.BlockCount * static_cast< int64 >( sizeof( FBlock ) ) +
+                             FileHeader.RunCount * static_cast< int64 >( sizeof( FRun ) ) +
+                             FileHeader.CharCount * static_cast< int64 >( sizeof( TCHAR ) );
+
+  DebugAssert( FileHeader.BlockCount < 0 || FileHeader.RunCount < 0 || FileHeader.CharCount < 0 || Size != ExpectedSize,
+               "The cooked interaction file '%s' is corrupt!", return false, DebugName )
+
+  return true;
+}
+
+bool FCookedInteractionFile::IsBlockValid( const FHeader &FileHeader, const FBlock &Block ) NoExcept
+{
+  return Block.FirstRun  >= 0 && Block.RunCount  >= 0 && static_cast< int64 >( Block.FirstRun  ) + Block.RunCount  <= FileHeader.RunCount &&
+         Block.FirstChar >= 0 && Block.CharCount >= 0 && static_cast< int64 >( Block.FirstChar ) + Block.CharCount <= FileHeader.CharCount;
+}
+
+bool FCookedInteractionFile::AreRunsValid( const FBlock &Block, const FRun *const BlockRuns ) NoExcept
+{
+  for( const FRun *Run = BlockRuns; Run != BlockRuns + Block.RunCount; ++Run )
+  {
+    if( Run->Offset < 0 || Run->Length < 0 || static_cast< int64 >( Run->Offset ) + Run->Length > Block.CharCount ) return false;
+
+    if( Run->Markup < 0 || Run->Markup >= FInteractionText::MarkupCombinations ) return false; // Indexes the font names
+  }
+
+  return true;
+}
+
+bool FCookedInteractionFile::Open( TArray< uint8 > &&Data, const TCHAR *const DebugName ) NoExcept
+{
+  OwnedData = MoveTemp( Data );
+
+  if( Open( OwnedData.GetData(), OwnedData.Num(), DebugName ) ) return true;
+
+  OwnedData.Empty();
+
+  return false;
+}
+
+FInteractionTextView FCookedInteractionFile::GetBlock( const int32 Block ) const NoExcept
+{
+  int32 CharCount;
+  int32 RunCount;
+
+  const TCHAR *const Text      = GetBlockText( Block, CharCount );
+  const FRun  *const BlockRuns = GetBlockRuns( Block, RunCount );
+
+  return Text ? FInteractionTextView{ Text, BlockRuns, RunCount } : FInteractionTextView{};
+}
+
+int64 FCookedInteractionFile::GetAllocatedSize() const NoExcept
+{
+  return OwnedData.GetAllocatedSize() + ( MappedRegion ? MappedRegion->GetMappedSize() : 0 );
+}
+
+const FCookedInteractionFile::FRun *FCookedInteractionFile::GetBlockRuns( const int32 Block, int32 &RunCount ) const NoExcept
+{
+  DebugAssert( Block < 0 || Block >= GetBlockCount(), "Block %i is out of range!", RunCount = 0; return nullptr, Block )
+
+  RunCount = Blocks[ Block ].RunCount;
+
+  return Runs + Blocks[ Block ].FirstRun;
+}
+
+const TCHAR *FCookedInteractionFile::GetBlockText( const int32 Block, int32 &CharCount ) const NoExcept
+{
+  DebugAssert( Block < 0 || Block >= GetBlockCount(), "Block %i is out of range!", CharCount = 0; return nullptr, Block )
+
+  CharCount = Blocks[ Block ].CharCount;
+
+  return Chars + Blocks[ Block ].FirstChar;
+}
+
+TArray< FInteractionText > FCookedInteractionFile::GetTextBlocks( const int32 First, const int32 Count ) const NoExcept
+{
+  TArray< FInteractionText > TextBlocks;
+
+  const int32 BlockCount = FMath::Clamp( GetBlockCount() - First, 0, Count );
+
+  TextBlocks.SetNum( BlockCount );
+
+  // Shared with any identical run that is already loaded
+  for( int32 i = First, End = First + BlockCount; i < End; ++i ) TextBlocks[ i - First ] = GetBlock( i ).ToText();
+
+  return TextBlocks; // NRVO
+}
+
+FString FCookedInteractionFile::GetCookedPath( const FName FileName ) NoExcept
+{
+  return UKismetSystemLibrary::GetProjectContentDirectory() + "InteractionTextFiles/Cooked/" + FileName.GetPlainNameString() + ".cooked";
+}
+
+bool FCookedInteractionFile::IsCooked( const FName FileName ) NoExcept
+{
+  const FDateTime CookedTime = IFileManager::Get().GetTimeStamp( *GetCookedPath( FileName ) );
+
+  if( CookedTime == FDateTime::MinValue() ) return false; // Not cooked
+
+#if WITH_EDITOR
+  // The writers could have changed the markup since it was cooked
+  if( IFileManager::Get().GetTimeStamp( *( UInteractionFileLoader::GetInteractionFilePath( FileName ) ) ) > CookedTime ) return false;
+#endif
+
+  return true;
+}
+
+bool FCookedInteractionFile::Write( const FString &Path, const TArray< FInteractionText > &TextBlocks ) NoExcept
+{
+  TArray< uint8 > Data;
+
+  Serialize( TextBlocks, Data );
+
+  return FFileHelper::SaveArrayToFile( Data, *Path );
+}
+
+void FCookedInteractionFile::Serialize( const TArray< FInteractionText > &TextBlocks, TArray< uint8 > &Data ) NoExcept
+{
+  FHeader FileHeader{ Magic, Version, sizeof( TCHAR ), TextBlocks.Num(), 0, 0 };
+
+  TArray< FBlock > FileBlocks;
+
+  FileBlocks.Reserve( TextBlocks.Num() );
+
+  for( const FInteractionText &Iter : TextBlocks )
+  {
+    FileBlocks.Add( { FileHeader.RunCount, Iter.Runs.Num(), FileHeader.CharCount, Iter.GetTextLength() } );
+
+    FileHeader.RunCount  += Iter.Runs.Num();
+    FileHeader.CharCount += Iter.GetTextLength();
+  }
+
+  Data.Reset();
+
+  Data.Reserve( sizeof( FHeader ) + FileBlocks.Num() * sizeof( FBlock ) + FileHeader.RunCount * sizeof( FRun ) +
+                FileHeader.CharCount * sizeof( TCHAR ) );
+
+  Data.Append( reinterpret_cast< const uint8* >( &FileHeader ), sizeof( FHeader ) );
+  Data.Append( reinterpret_cast< const uint8* >( FileBlocks.GetData() ), FileBlocks.Num() * sizeof( FBlock ) );
+
+  // The runs are written with offsets into their block's text, which is each run's text back to back
+  for( const FInteractionText &Iter : TextBlocks )
+  {
+    int32 Offset = 0;
+
+    for( const FInteractionText::FRun &Run : Iter.Runs )
+    {
+      const FRun FileRun{ Offset, Run.Num(), Run.Markup, Run.Parameter };
+
+      Data.Append( reinterpret_cast< const uint8* >( &FileRun ), sizeof( FRun ) );
+
+      Offset += Run.Num();
+    }
+  }
+
+  for( const FInteractionText &Iter : TextBlocks )
+  {
+    for( const FInteractionText::FRun &Run : Iter.Runs ) Data.Append( reinterpret_cast< const uint8* >( Run.GetData() ), Run.Num() * sizeof( TCHAR ) );
+  }
+}
@@ -0,0 +1,123 @@
+/*!------------------------------------------------------------------------------
+\file   CookedInteractionFile.h
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#pragma once
+
+// Unreal Includes
+#include "CoreMinimal.h"
+#include "Templates/UniquePtr.h"
+
+// Our Includes
+#include "Public/InteractionText/InteractionFileLoader.h"
+#include "Public/InteractionText/InteractionMarkupParser.h" // InteractionMarkup::FRun
+#include "Public/Utils/Macros.h"
+
+// Commonly used forward declarations
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+// An interaction file that was already parsed by the CookInteractionText commandlet.
+// Loading it skips the markup parser, and the FInteractionTextBlocks keeps it open so blocks are read in place out of the mapping.
+//
+// Layout:
+//   FHeader
+//   FBlock [ BlockCount ]
+//   FRun   [ RunCount   ] // Offsets are relative to the block's FirstChar
+//   TCHAR  [ CharCount  ]
+class VIRIDIAN_API FCookedInteractionFile
+{
+  public:
+    static constexpr uint32 Magic   = 0x54434956; // "VICT"
+    static constexpr uint32 Version = 3;          // Bump this whenever the layout or the markup bits change, old files will be re-parsed instead
+
+    using FRun = InteractionMarkup::FRun; // Plain offsets into the block's text, the parsed blocks intern each run's text instead
+
+    struct FHeader
+    {
+      uint32 Magic;
+      uint32 Version;
+      uint32 CharSize; // sizeof( TCHAR ) of the platform that cooked it
+      int32  BlockCount;
+      int32  RunCount;
+      int32  CharCount;
+    };
+
+    struct FBlock
+    {
+      int32 FirstRun;
+      int32 RunCount;
+      int32 FirstChar;
+      int32 CharCount;
+    };
+
+  public:
+    FCookedInteractionFile() NoExcept;
+    ~FCookedInteractionFile() NoExcept;
+
+  public:
+    // Maps the cooked version of the file, returns false if there isn't one or it is out of date.
+    // In the editor the markup is also checked, since the writers could have changed it since it was cooked.
+    bool Open( FName FileName ) NoExcept;
+
+    // Reads a cooked file that is already in memory, such as one from the FInteractionTextArchive. The Data must outlive this.
+    bool Open( const uint8 *Data, int64 Size, const TCHAR *DebugName ) NoExcept;
+
+    // Same as above, but keeps the Data for as long as this is open
+    bool Open( TArray< uint8 > &&Data, const TCHAR *DebugName ) NoExcept;
+
+    int32 GetBlockCount() const NoExcept { return Header ? Header->BlockCount : 0; }
+    int32 GetRunCount  () const NoExcept { return Header ? Header->RunCount   : 0; }
+
+    // Only valid while this is open, invalid if the block is out of range
+    FInteractionTextView GetBlock( int32 Block ) const NoExcept;
+
+    // The mapped or owned data
+    int64 GetAllocatedSize() const NoExcept;
+
+    // Copies the blocks out of the mapped file. Count is clamped to the blocks in the file.
+    TArray< FInteractionText > GetTextBlocks( int32 First = 0, int32 Count = MAX_int32 ) const NoExcept;
+
+  public:
+    static FString GetCookedPath( FName FileName ) NoExcept;
+
+    // Whether there is a cooked file that is newer than the markup, it can still fail to open if it was cooked by an older version
+    static bool IsCooked( FName FileName ) NoExcept;
+
+    // Writes the parsed blocks in the cooked layout
+    static bool Write( const FString &Path, const TArray< FInteractionText > &TextBlocks ) NoExcept;
+
+    static void Serialize( const TArray< FInteractionText > &TextBlocks, TArray< uint8 > &Data ) NoExcept;
+
+    // Checks the version and that the counts add up to Size, for readers that don't map the whole file such as the FInteractionFileStream
+    static bool IsHeaderValid( const FHeader &FileHeader, int64 Size, const TCHAR *DebugName ) NoExcept;
+
+    // Whether the block is within the file's runs and text
+    static bool IsBlockValid( const FHeader &FileHeader, const FBlock &Block ) NoExcept;
+
+    // Whether the block's runs are within its text and have known markups
+    static bool AreRunsValid( const FBlock &Block, const FRun *BlockRuns ) NoExcept;
+
+  private:
+    // Only valid while this is open
+    const FRun  *GetBlockRuns( int32 Block, int32 &RunCount ) const NoExcept;
+    const TCHAR *GetBlockText( int32 Block, int32 &CharCount ) const NoExcept;
+
+  private:
+    TUniquePtr< IMappedFileHandle > MappedFile;
+    TUniquePtr< IMappedFileRegion > MappedRegion; // Must be released before the MappedFile
+
+    TArray< uint8 > OwnedData; // Empty unless it was opened with the data moved in
+
+    const FHeader *Header = nullptr;
+    const FBlock  *Blocks = nullptr;
+    const FRun    *Runs   = nullptr;
+    const TCHAR   *Chars  = nullptr;
+};
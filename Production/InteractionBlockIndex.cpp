@@ -0,0 +1,130 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionBlockIndex.cpp
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#include "Public/InteractionText/InteractionBlockIndex.h"
+
+// Unreal Includes
+#include "HAL/FileManager.h"
+#include "Misc/ScopeLock.h"
+
+// Our Includes
+#include "Public/InteractionText/InteractionFileLoader.h"
+
+// STL Includes
+#include <cstring> // memchr
+#include <fstream>
+
+FInteractionBlockIndex &FInteractionBlockIndex::Get() NoExcept
+{
+  static FInteractionBlockIndex BlockIndex;
+
+  return BlockIndex;
+}
+
+bool FInteractionBlockIndex::GetByteRange( const FName FileName, const int32 First, const int32 Count, int64 &Begin, int64 &End ) NoExcept
+{
+  const FString FilePath = UInteractionFileLoader::GetInteractionFilePath( FileName );
+
+#if WITH_EDITOR
+  const FDateTime TimeStamp = IFileManager::Get().GetTimeStamp( *FilePath );
+#endif
+
+  // Null if the file was never indexed, or changed since it was
+  auto FindIndex = [ & ]()NoExcept->const FIndex*
+  {
+    const FIndex *const Index = Indices.Find( FileName );
+
+#if WITH_EDITOR
+    if( Index && Index->TimeStamp != TimeStamp ) return nullptr;
+#endif
+
+    return Index;
+  };
+
+  auto SetByteRange = [ & ]( const FIndex &Index )NoExcept->void
+  {
+    const int32 BlockCount = Index.BlockStarts.Num() - 1;
+
+    const int32 ClampedFirst = FMath::Min( First, BlockCount );
+
+    Begin = Index.BlockStarts[ ClampedFirst ];
+    End   = Index.BlockStarts[ ClampedFirst + FMath::Min( Count, BlockCount - ClampedFirst ) ];
+  };
+
+  {
+    FScopeLock ScopeLock{ &Lock };
+
+    if( const FIndex *const Index = FindIndex() )
+    {
+      SetByteRange( *Index );
+
+      return true;
+    }
+  }
+
+  // Built without the lock, reading the whole file would stall every other file's lookups
+  FIndex NewIndex;
+
+  if( !( Build( FilePath, NewIndex ) ) ) return false;
+
+  FScopeLock ScopeLock{ &Lock };
+
+  const FIndex *Index = FindIndex(); // Another thread could have built it at the same time, keep theirs
+
+  if( !Index ) Index = &( Indices.Add( FileName, std::move( NewIndex ) ) );
+
+  SetByteRange( *Index );
+
+  return true;
+}
+
+void FInteractionBlockIndex::Remove( const FName FileName ) NoExcept
+{
+  FScopeLock ScopeLock{ &Lock };
+
+  Indices.Remove( FileName );
+}
+
+bool FInteractionBlockIndex::Build( const FString &FilePath, FIndex &Index ) NoExcept
+{
+  std::ifstream InputFile{ *FilePath, std::ifstream::binary };
+
+  DebugAssert( !( InputFile.is_open() ), "Unable to open file '%s'!", return false, *FilePath )
+
+#if WITH_EDITOR
+  Index.TimeStamp = IFileManager::Get().GetTimeStamp( *FilePath );
+#endif
+
+  Index.BlockStarts.Add( 0 );
+
+  // Only the newlines are needed, so the file is streamed through a small buffer instead of loaded whole
+  TArray< char > ChunkBuffer;
+
+  ChunkBuffer.SetNumUninitialized( 64 * 1024 ); // Not on the stack, this can run on worker threads
+
+  const char *const Chunk = ChunkBuffer.GetData();
+
+  for( int64 ChunkStart = 0; InputFile; )
+  {
+    InputFile.read( ChunkBuffer.GetData(), ChunkBuffer.Num() );
+
+    const char *const ChunkEnd = Chunk + InputFile.gcount();
+
+    for( const char *Iter = Chunk; ( Iter = static_cast< const char* >( std::memchr( Iter, '\n', ChunkEnd - Iter ) ) ) != nullptr; ++Iter )
+    {
+      Index.BlockStarts.Add( ChunkStart + ( Iter - Chunk ) + 1 ); // The next block starts after the newline
+    }
+
+    ChunkStart += InputFile.gcount();
+  }
+
+  return true;
+}
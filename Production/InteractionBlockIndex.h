@@ -0,0 +1,55 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionBlockIndex.h
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#pragma once
+
+// Unreal Includes
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+// Our Includes
+#include "Public/Utils/Macros.h"
+
+// Remembers where each block starts in the raw markup files, so single blocks can be read without parsing everything before them.
+// The index for a file is built the first time a block is asked for. Safe to call from any thread.
+class VIRIDIAN_API FInteractionBlockIndex
+{
+  public:
+    static FInteractionBlockIndex &Get() NoExcept;
+
+  public:
+    // Gets the bytes [ Begin, End ) that hold Count blocks starting at First, including their '\n'.
+    // Count is clamped to the blocks in the file, returns false if the file could not be read.
+    bool GetByteRange( FName FileName, int32 First, int32 Count, int64 &Begin, int64 &End ) NoExcept;
+
+    // Forgets the file's index so it is rebuilt the next time it is used
+    void Remove( FName FileName ) NoExcept;
+
+  private:
+    struct FIndex
+    {
+      TArray< int64 > BlockStarts; // Has one extra element at the end, one past the last block's '\n'
+
+#if WITH_EDITOR
+      FDateTime TimeStamp; // The writers could change the file while the editor is running
+#endif
+    };
+
+  private:
+    FInteractionBlockIndex() NoExcept {}
+
+    static bool Build( const FString &FilePath, FIndex &Index ) NoExcept;
+
+  private:
+    FCriticalSection Lock;
+
+    TMap< FName, FIndex > Indices;
+};
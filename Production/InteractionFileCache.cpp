@@ -0,0 +1,244 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionFileCache.cpp
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#include "Public/InteractionText/InteractionFileCache.h"
+
+// Unreal Includes
+#include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+
+// Our Includes
+#include "Public/InteractionText/InteractionTextStats.h"
+
+static TAutoConsoleVariable< int32 > CVarCacheBudgetKB( TEXT( "Viridian.InteractionText.CacheBudgetKB" ), 16 * 1024,
+                                                        TEXT( "How many KB of parsed interaction files can stay resident before the least recently used are evicted." ) );
+
+FInteractionFileCache &FInteractionFileCache::Get() NoExcept
+{
+  static FInteractionFileCache Cache;
+
+  return Cache;
+}
+
+FInteractionFileCache::FTextBlocksRef FInteractionFileCache::Load( const FName FileName ) NoExcept
+{
+  {
+    FScopeLock ScopeLock{ &Lock };
+
+    if( FEntry *const Entry = Entries.Find( FileName ) )
+    {
+      ++( Stats.Hits );
+
+      FInteractionTextStats::Get().AddCacheHit( FileName );
+
+      Touch( *Entry );
+
+      return Entry->TextBlocks;
+    }
+
+    ++( Stats.Misses );
+
+    FInteractionTextStats::Get().AddCacheMiss( FileName );
+  }
+
+  // Parse without holding the lock so other threads can still hit the cache
+  const FTextBlocksPtr TextBlocks = UInteractionFileLoader::ReadInteractionFile( FileName );
+
+  // Not cached, so the next load tries the file again instead of getting an empty one
+  if( !( TextBlocks.IsValid() ) ) return MakeShared< const FInteractionTextBlocks, ESPMode::ThreadSafe >( TArray< FInteractionText >{} );
+
+  FScopeLock ScopeLock{ &Lock };
+
+  return Add( FileName, TextBlocks.ToSharedRef() ).TextBlocks; // Another thread may have added it first, theirs is used
+}
+
+FInteractionFileCache::FTextBlocksPtr FInteractionFileCache::Find( const FName FileName ) NoExcept
+{
+  FScopeLock ScopeLock{ &Lock };
+
+  FEntry *const Entry = Entries.Find( FileName );
+
+  if( !Entry ) return nullptr; // Not counted as a miss, nothing is loaded
+
+  ++( Stats.Hits );
+
+  FInteractionTextStats::Get().AddCacheHit( FileName );
+
+  Touch( *Entry );
+
+  return Entry->TextBlocks;
+}
+
+TFuture< FInteractionFileCache::FTextBlocksPtr > FInteractionFileCache::LoadAsync( const FName FileName ) NoExcept
+{
+  return Async< FTextBlocksPtr >( EAsyncExecution::ThreadPool, [ this, FileName ]()NoExcept->FTextBlocksPtr
+  {
+    return Load( FileName );
+  } );
+}
+
+void FInteractionFileCache::LoadAsync( const FName FileName, FOnLoaded OnLoaded ) NoExcept
+{
+  // A hit would not need the thread pool, but going through it keeps the callback from ever running inside this call
+  AsyncTask( ENamedThreads::AnyBackgroundThreadNormalTask, [ this, FileName, OnLoaded = MoveTemp( OnLoaded ) ]()mutable NoExcept->void
+  {
+    const FTextBlocksRef TextBlocks = Load( FileName );
+
+    AsyncTask( ENamedThreads::GameThread, [ TextBlocks, OnLoaded = MoveTemp( OnLoaded ) ]()NoExcept->void
+    {
+      OnLoaded( TextBlocks );
+    } );
+  } );
+}
+
+void FInteractionFileCache::Pin( const FName FileName ) NoExcept
+{
+  {
+    FScopeLock ScopeLock{ &Lock };
+
+    ++( PinCounts.FindOrAdd( FileName ) ); // Counted before it is loaded, so it can never be evicted in between
+  }
+
+  Load( FileName );
+}
+
+void FInteractionFileCache::Unpin( const FName FileName ) NoExcept
+{
+  FScopeLock ScopeLock{ &Lock };
+
+  int32 *const PinCount = PinCounts.Find( FileName );
+
+  DebugAssert( !PinCount, "Unpinned the interaction file '%s' more times than it was pinned!", return, *FileName.ToString() )
+
+  if( --( *PinCount ) ) return;
+
+  PinCounts.Remove( FileName );
+
+  EvictOverBudget(); // It may have been the only thing keeping us over budget
+}
+
+void FInteractionFileCache::Replace( const FName FileName, const FTextBlocksRef &TextBlocks ) NoExcept
+{
+  FScopeLock ScopeLock{ &Lock };
+
+  FEntry *const Entry = Entries.Find( FileName );
+
+  if( !Entry ) // Not resident, just add it like a normal load
+  {
+    Add( FileName, TextBlocks );
+
+    return;
+  }
+
+  const int64 Bytes = TextBlocks->GetAllocatedSize();
+
+  Stats.ResidentBytes += Bytes - Entry->Bytes;
+
+  Entry->TextBlocks = TextBlocks; // Anyone still holding the old blocks keeps them alive
+  Entry->Bytes      = Bytes;
+
+  Touch( *Entry );
+
+  EvictOverBudget();
+}
+
+void FInteractionFileCache::Remove( const FName FileName ) NoExcept
+{
+  FScopeLock ScopeLock{ &Lock };
+
+  if( FEntry *const Entry = Entries.Find( FileName ) )
+  {
+    Stats.ResidentBytes -= Entry->Bytes;
+
+    LruList.RemoveNode( Entry->LruNode );
+
+    Entries.Remove( FileName );
+  }
+}
+
+void FInteractionFileCache::Empty() NoExcept
+{
+  FScopeLock ScopeLock{ &Lock };
+
+  Entries.Empty();
+  LruList.Empty();
+
+  Stats.ResidentBytes = 0;
+}
+
+FInteractionFileCache::FStats FInteractionFileCache::GetStats() const NoExcept
+{
+  FScopeLock ScopeLock{ &Lock };
+
+  FStats Copy = Stats;
+
+  Copy.FileCount = Entries.Num();
+
+  return Copy; // NRVO
+}
+
+FInteractionFileCache::FEntry &FInteractionFileCache::Add( const FName FileName, const FTextBlocksRef &TextBlocks ) NoExcept
+{
+  if( FEntry *const Existing = Entries.Find( FileName ) )
+  {
+    Touch( *Existing );
+
+    return *Existing;
+  }
+
+  FEntry &Entry = Entries.Emplace( FileName, FEntry{ TextBlocks, TextBlocks->GetAllocatedSize() } );
+
+  LruList.AddHead( FileName );
+
+  Entry.LruNode = LruList.GetHead();
+
+  Stats.ResidentBytes += Entry.Bytes;
+
+  EvictOverBudget( FileName ); // Never evict what we just added, even if it is larger than the whole budget
+
+  return Entries[ FileName ]; // Evicting can move the map's elements
+}
+
+void FInteractionFileCache::Touch( FEntry &Entry ) NoExcept
+{
+  // Move it to the front, without reallocating the node
+  LruList.RemoveNode( Entry.LruNode, false );
+  LruList.AddHead( Entry.LruNode );
+}
+
+void FInteractionFileCache::EvictOverBudget( const FName Keep ) NoExcept
+{
+  const int64 Budget = static_cast< int64 >( CVarCacheBudgetKB.GetValueOnAnyThread() ) * 1024;
+
+  // Start at the least recently used, skipping anything that is pinned
+  for( auto *Node = LruList.GetTail(); Node && Stats.ResidentBytes > Budget; )
+  {
+    auto *const Next = Node->GetPrevNode();
+
+    const FName FileName = Node->GetValue();
+
+    if( FileName != Keep && !( PinCounts.Contains( FileName ) ) )
+    {
+      FEntry &Entry = Entries[ FileName ];
+
+      Stats.ResidentBytes -= Entry.Bytes;
+
+      ++( Stats.Evictions );
+
+      LruList.RemoveNode( Node );
+
+      Entries.Remove( FileName ); // Anyone still holding the TextBlocks keeps them alive
+    }
+
+    Node = Next;
+  }
+}
@@ -0,0 +1,105 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionFileCache.h
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#pragma once
+
+// Unreal Includes
+#include "CoreMinimal.h"
+#include "Containers/List.h"
+#include "Async/Future.h"
+#include "HAL/CriticalSection.h"
+
+// Our Includes
+#include "Public/InteractionText/InteractionFileLoader.h"
+#include "Public/Utils/Macros.h"
+
+// Keeps parsed interaction files resident so they are only read once.
+// Least recently used files are evicted once the cache goes over its budget (Viridian.InteractionText.CacheBudgetKB).
+// Every function is safe to call from any thread.
+class VIRIDIAN_API FInteractionFileCache
+{
+  public:
+    // Parsed files are never changed once they are cached, so they can be shared between threads
+    using FTextBlocksRef = FInteractionDocument::FTextBlocksRef;
+    using FTextBlocksPtr = FInteractionDocument::FTextBlocksPtr; // TFuture needs a default
+
+    using FOnLoaded = TFunction< void( const FTextBlocksRef &TextBlocks ) >;
+
+    struct FStats
+    {
+      int64 Hits          = 0;
+      int64 Misses        = 0;
+      int64 Evictions     = 0;
+      int64 ResidentBytes = 0;
+      int32 FileCount     = 0;
+    };
+
+  public:
+    static FInteractionFileCache &Get() NoExcept;
+
+  public:
+    // Returns the cached file, reading and parsing it on a miss
+    FTextBlocksRef Load( FName FileName ) NoExcept;
+
+    // Returns the cached file without loading it on a miss, null if it is not resident
+    FTextBlocksPtr Find( FName FileName ) NoExcept;
+
+    // Reads and parses the file on the thread pool, the future is set from that thread
+    TFuture< FTextBlocksPtr > LoadAsync( FName FileName ) NoExcept;
+
+    // Reads and parses the file on the thread pool, then calls OnLoaded on the game thread
+    void LoadAsync( FName FileName, FOnLoaded OnLoaded ) NoExcept;
+
+    // Pinned files are never evicted, pins are counted so every Pin needs an Unpin.
+    // Pins are kept apart from the cached files, so they outlive a Remove or Empty and apply again once the file is reloaded.
+    void Pin  ( FName FileName ) NoExcept;
+    void Unpin( FName FileName ) NoExcept;
+
+    // Swaps in a newer parse of the file, any pins are kept. Used by the hot reload.
+    void Replace( FName FileName, const FTextBlocksRef &TextBlocks ) NoExcept;
+
+    // Drops the file so the next load reads it again, even if it is pinned
+    void Remove( FName FileName ) NoExcept;
+
+    void Empty() NoExcept;
+
+    FStats GetStats() const NoExcept;
+
+  private:
+    struct FEntry
+    {
+      FEntry( const FTextBlocksRef &Blocks, int64 Size ) NoExcept : TextBlocks{ Blocks }, Bytes{ Size } {}
+
+      FTextBlocksRef TextBlocks;
+
+      int64 Bytes;
+
+      TDoubleLinkedList< FName >::TDoubleLinkedListNode *LruNode = nullptr; // Head is the most recently used
+    };
+
+  private:
+    FInteractionFileCache() NoExcept {}
+
+    FEntry &Add( FName FileName, const FTextBlocksRef &TextBlocks ) NoExcept; // Lock must be held
+    void Touch( FEntry &Entry ) NoExcept;                                     // Lock must be held
+    void EvictOverBudget( FName Keep = NAME_None ) NoExcept;                  // Lock must be held
+
+  private:
+    mutable FCriticalSection Lock;
+
+    TMap< FName, FEntry > Entries;
+
+    TDoubleLinkedList< FName > LruList;
+
+    TMap< FName, int32 > PinCounts; // Only files with at least one pin
+
+    FStats Stats;
+};
@@ -10,239 +10,813 @@
 ------------------------------------------------------------------------------ */
 
 #include "Public/InteractionText/InteractionFileLoader.h"
+#include "Public/InteractionText/CookedInteractionFile.h"
+#include "Public/InteractionText/InteractionFileCache.h"
+#include "Public/InteractionText/InteractionBlockIndex.h"
+#include "Public/InteractionText/InteractionMarkupParser.h"
+#include "Public/InteractionText/InteractionTextArchive.h"
+#include "Public/InteractionText/InteractionTextDecoder.h"
+#include "Public/InteractionText/InteractionTextStats.h"
+
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/IConsoleManager.h"
+
 #include "Kismet/KismetSystemLibrary.h"
+#include "Engine/Engine.h"
+#include "LatentActions.h"
+#include "Misc/FileHelper.h"
 
 #include <fstream>
 
-FInteractionText::FInteractionText( FInteractionText &&Move ) NoExcept : Text{ std::move( Move.Text ) }, TextMarkup{ std::move( Move.TextMarkup ) } {}
+static TAutoConsoleVariable< int32 > CVarParallelParseKB( TEXT( "Viridian.InteractionText.ParallelParseKB" ), 256,
+                                                          TEXT( "Interaction files at least this many KB are split up and parsed on multiple threads, 0 disables it." ) );
+
+static TAutoConsoleVariable< int32 > CVarCoalesceRuns( TEXT( "Viridian.InteractionText.CoalesceRuns" ), 0,
+                                                       TEXT( "1 merges neighboring runs with the same markups after parsing a block, off by default." ) );
+
+static constexpr size_t MinParallelChunkSize = 64 * 1024; // Smaller chunks cost more to schedule than to parse
+
+FInteractionText::FInteractionText( const FInteractionText &Copy ) NoExcept : Runs{ Copy.Runs } {}
+
+FInteractionText::FInteractionText( FInteractionText &&Move ) NoExcept : Runs{ std::move( Move.Runs ) } {}
 
 void FInteractionText::operator=( const FInteractionText &Copy ) NoExcept
 {
-  Text       = Copy.Text;
-  TextMarkup = Copy.TextMarkup;
+  Runs = Copy.Runs;
 }
 
 void FInteractionText::operator=( FInteractionText &&Move ) NoExcept
 {
-  Text       = std::move( Move.Text );
-  TextMarkup = std::move( Move.TextMarkup );
+  Runs = std::move( Move.Runs );
+}
+
+void FInteractionText::AddRun( const TCHAR *const Text, const int32 Length, const int32 Markup, const int32 Parameter ) NoExcept
+{
+  Runs.Add( { FInteractionStringTable::Get().Intern( Text, Length ), Markup, Parameter } );
+}
+
+int32 FInteractionText::GetTextLength() const NoExcept
+{
+  int32 Length = 0;
+
+  for( const FRun &Iter : Runs ) Length += Iter.Num();
+
+  return Length;
+}
+
+FString FInteractionText::GetRunText( const int32 Run ) const NoExcept
+{
+  DebugAssert( !( Runs.IsValidIndex( Run ) ), "Run %i is out of range, the block only has %i runs!", return FString{}, Run, Runs.Num() )
+
+  return FString{ Runs[ Run ].Num(), Runs[ Run ].GetData() };
+}
+
+void FInteractionText::CoalesceRuns() NoExcept
+{
+  TArray< FRun > Coalesced;
+
+  Coalesced.Reserve( Runs.Num() );
+
+  TArray< TCHAR > Text; // The text of the run being merged into
+
+  for( int32 i = 0; i < Runs.Num(); )
+  {
+    int32 Next = i + 1;
+
+    // Empty runs are dropped, so they never stop a merge
+    while( Next < Runs.Num() && ( !( Runs[ Next ].Num() ) ||
+                                  ( Runs[ Next ].Markup == Runs[ i ].Markup && Runs[ Next ].Parameter == Runs[ i ].Parameter ) ) ) ++Next;
+
+    if( Next == i + 1 ) // Nothing to merge, the interned text is kept as is
+    {
+      if( Runs[ i ].Num() ) Coalesced.Add( std::move( Runs[ i ] ) );
+    }
+    else
+    {
+      Text.Reset();
+
+      for( int32 Run = i; Run < Next; ++Run ) Text.Append( Runs[ Run ].GetData(), Runs[ Run ].Num() );
+
+      if( Text.Num() ) Coalesced.Add( { FInteractionStringTable::Get().Intern( Text.GetData(), Text.Num() ), Runs[ i ].Markup, Runs[ i ].Parameter } );
+    }
+
+    i = Next;
+  }
+
+  Runs = std::move( Coalesced );
+}
+
+const FName &FInteractionText::GetMarkupName( const int32 Markup ) NoExcept
+{
+  // There are only a few possible bitmasks, so every name is built once instead of for every run
+  static const TArray< FName > MarkupNames = []()NoExcept->TArray< FName >
+  {
+    TArray< FName > Names;
+
+    Names.Reserve( MarkupCombinations );
+
+    Names.Emplace( TEXT( "Regular" ) );
+
+    for( int32 Mask = 1; Mask < MarkupCombinations; ++Mask )
+    {
+      FString Name;
+
+      for( int32 i = 0; i < MaxMaskCount; ++i )
+      {
+        if( ( Mask & ( 1 << i ) ) && InteractionMarkup::Markups[ i ].StyleName ) // Such as color, which does not change the font
+        {
+          if( !( Name.IsEmpty() ) ) Name.AppendChar( ' ' ); // Don't add an extra space before the first markup
+
+          Name.Append( InteractionMarkup::Markups[ i ].StyleName );
+        }
+      }
+
+      Names.Emplace( Name.IsEmpty() ? TEXT( "Regular" ) : *Name ); // Only markups that don't change the font
+    }
+
+    return Names; // NRVO
+  }();
+
+  DebugAssert( Markup < 0 || Markup >= MarkupCombinations, "Invalid markup bitmask %i!", return MarkupNames[ 0 ], Markup )
+
+  return MarkupNames[ Markup ];
+}
+
+const TCHAR *FInteractionTextView::GetRunText( const int32 Run, int32 &Length ) const NoExcept
+{
+  DebugAssert( Run < 0 || Run >= RunCount, "Run %i is out of range, the block only has %i runs!", Length = 0; return nullptr, Run, RunCount )
+
+  if( Parsed )
+  {
+    Length = Parsed->Runs[ Run ].Num();
+
+    return Parsed->Runs[ Run ].GetData();
+  }
+
+  Length = CookedRuns[ Run ].Length;
+
+  return CookedText + CookedRuns[ Run ].Offset;
+}
+
+FString FInteractionTextView::GetRunString( const int32 Run ) const NoExcept
+{
+  int32 Length;
+
+  const TCHAR *const Text = GetRunText( Run, Length );
+
+  return Text ? FString{ Length, Text } : FString{};
+}
+
+int32 FInteractionTextView::GetRunMarkup( const int32 Run ) const NoExcept
+{
+  DebugAssert( Run < 0 || Run >= RunCount, "Run %i is out of range, the block only has %i runs!", return 0, Run, RunCount )
+
+  return Parsed ? Parsed->Runs[ Run ].Markup : CookedRuns[ Run ].Markup;
+}
+
+int32 FInteractionTextView::GetRunParameter( const int32 Run ) const NoExcept
+{
+  DebugAssert( Run < 0 || Run >= RunCount, "Run %i is out of range, the block only has %i runs!", return 0, Run, RunCount )
+
+  return Parsed ? Parsed->Runs[ Run ].Parameter : CookedRuns[ Run ].Parameter;
+}
+
+int32 FInteractionTextView::GetTextLength() const NoExcept
+{
+  if( Parsed ) return Parsed->GetTextLength();
+
+  int32 Length = 0;
+
+  for( int32 i = 0; i < RunCount; ++i ) Length += CookedRuns[ i ].Length;
+
+  return Length;
+}
+
+FInteractionText FInteractionTextView::ToText() const NoExcept
+{
+  if( Parsed ) return *Parsed;
+
+  FInteractionText TextBlock;
+
+  TextBlock.Runs.Reserve( RunCount );
+
+  // Shared with any identical run that is already loaded
+  for( const InteractionMarkup::FRun *Iter = CookedRuns; Iter != CookedRuns + RunCount; ++Iter )
+  {
+    TextBlock.AddRun( CookedText + Iter->Offset, Iter->Length, Iter->Markup, Iter->Parameter );
+  }
+
+  return TextBlock; // NRVO
+}
+
+FInteractionTextBlocks::FInteractionTextBlocks( TArray< FInteractionText > &&TextBlocks ) NoExcept : Parsed{ MoveTemp( TextBlocks ) } {}
+
+FInteractionTextBlocks::FInteractionTextBlocks( TUniquePtr< FCookedInteractionFile > &&CookedFile ) NoExcept : Cooked{ MoveTemp( CookedFile ) } {}
+
+FInteractionTextBlocks::~FInteractionTextBlocks() NoExcept {}
+
+int32 FInteractionTextBlocks::Num() const NoExcept
+{
+  return Cooked ? Cooked->GetBlockCount() : Parsed.Num();
+}
+
+FInteractionTextView FInteractionTextBlocks::GetBlock( const int32 Block ) const NoExcept
+{
+  if( !( IsValidIndex( Block ) ) ) return FInteractionTextView{};
+
+  return Cooked ? Cooked->GetBlock( Block ) : FInteractionTextView{ Parsed[ Block ] };
+}
+
+TArray< FInteractionText > FInteractionTextBlocks::CopyBlocks( const int32 First, const int32 Count ) const NoExcept
+{
+  if( Cooked ) return Cooked->GetTextBlocks( First, Count );
+
+  const int32 BlockCount = FMath::Clamp( Parsed.Num() - First, 0, Count );
+
+  return BlockCount ? TArray< FInteractionText >{ Parsed.GetData() + First, BlockCount } : TArray< FInteractionText >{};
+}
+
+int64 FInteractionTextBlocks::GetAllocatedSize() const NoExcept
+{
+  if( Cooked ) return Cooked->GetAllocatedSize();
+
+  int64 Bytes = Parsed.GetAllocatedSize();
+
+  for( const FInteractionText &Iter : Parsed ) Bytes += Iter.GetTextLength() * sizeof( TCHAR ) + Iter.Runs.GetAllocatedSize();
+
+  return Bytes;
+}
+
+FInteractionTextView FInteractionDocument::GetBlock( const int32 Block ) const NoExcept
+{
+  return TextBlocks.IsValid() ? TextBlocks->GetBlock( Block ) : FInteractionTextView{};
 }
 
 TArray< FInteractionText > UInteractionFileLoader::LoadInteractionFile( const FName FileName ) NoExcept
 {
-  std::string FullText{}; // Wholes all of the text from the file
+  return FInteractionFileCache::Get().Load( FileName )->CopyBlocks();
+}
+
+FInteractionDocument UInteractionFileLoader::LoadInteractionDocument( const FName FileName ) NoExcept
+{
+  return FInteractionDocument{ FInteractionFileCache::Get().Load( FileName ) };
+}
+
+namespace
+{
+  // Copies the whole file for LoadInteractionFileAsync
+  void SetOutput( TArray< FInteractionText > &Output, const FInteractionFileCache::FTextBlocksPtr &TextBlocks ) NoExcept
+  {
+    Output = TextBlocks->CopyBlocks();
+  }
 
-  // Load the file
+  // Only adds a reference for LoadInteractionDocumentAsync
+  void SetOutput( FInteractionDocument &Output, const FInteractionFileCache::FTextBlocksPtr &TextBlocks ) NoExcept
   {
-    std::ifstream InputFile{ *( UKismetSystemLibrary::GetProjectContentDirectory() + "InteractionTextFiles/" + FileName.GetPlainNameString() ) };
+    Output = FInteractionDocument{ TextBlocks };
+  }
+
+  // Waits for the background load, then sets the Blueprint's output on the game thread
+  template < typename T >
+  class FLoadInteractionFileAction : public FPendingLatentAction
+  {
+    public:
+      FLoadInteractionFileAction( const FName FileName, T &Output, const FLatentActionInfo &LatentInfo ) NoExcept :
+      Output( Output ), Future( FInteractionFileCache::Get().LoadAsync( FileName ) ),
+      ExecutionFunction( LatentInfo.ExecutionFunction ), OutputLink( LatentInfo.Linkage ), CallbackTarget( LatentInfo.CallbackTarget ) {}
 
-    DebugAssert( !( InputFile.is_open() ), "Unable to open file '%s'!", return TArray< FInteractionText >{},
-                 *( UKismetSystemLibrary::GetProjectContentDirectory() + "InteractionTextFiles/" + FileName.GetPlainNameString() ) )
+    public:
+      void UpdateOperation( FLatentResponse &Response ) NoExcept override
+      {
+        if( !( Future.IsReady() ) ) return;
 
-    // Get how large the file is
-    InputFile.seekg( 0, std::ifstream::end );
+        SetOutput( Output, Future.Get() );
 
-    const size_t Size = static_cast< size_t >( InputFile.tellg() );
+        Response.FinishAndTriggerIf( true, ExecutionFunction, OutputLink, CallbackTarget );
+      }
 
-    // Resize the string to the exact size it needs to be
-    FullText.resize( Size );
+    private:
+      T &Output;
 
-    InputFile.seekg( 0, std::ifstream::beg );
+      TFuture< FInteractionFileCache::FTextBlocksPtr > Future;
 
-    // Load the entire file into the string
-    InputFile.read( &( FullText.front() ), Size );
+      const FName ExecutionFunction;
+      const int32 OutputLink;
+      const FWeakObjectPtr CallbackTarget;
+  };
 
-    InputFile.close();
+  template < typename T >
+  void AddLoadAction( UObject *const WorldContextObject, const FName FileName, T &Output, const FLatentActionInfo &LatentInfo ) NoExcept
+  {
+    UWorld *const World = GEngine->GetWorldFromContextObject( WorldContextObject, EGetWorldErrorMode::LogAndReturnNull );
+
+    if( !World ) return;
+
+    FLatentActionManager &LatentManager = World->GetLatentActionManager();
+
+    // Calling the node again while it is still loading does nothing, just like Delay
+    if( LatentManager.FindExistingAction< FLoadInteractionFileAction< T > >( LatentInfo.CallbackTarget, LatentInfo.UUID ) ) return;
+
+    LatentManager.AddNewAction( LatentInfo.CallbackTarget, LatentInfo.UUID, new FLoadInteractionFileAction< T >{ FileName, Output, LatentInfo } );
   }
+}
 
-  // All of the blocks of text, each one has an array of text to render for that block and the markups for the text.
-  TArray< FInteractionText > TextBlocks;
+void UInteractionFileLoader::LoadInteractionFileAsync( UObject *const WorldContextObject, const FName FileName, TArray< FInteractionText > &TextBlocks,
+                                                       const FLatentActionInfo LatentInfo ) NoExcept
+{
+  AddLoadAction( WorldContextObject, FileName, TextBlocks, LatentInfo );
+}
 
-  size_t TextIndex = 0; // Our current index into the FullText
-  
-  for( FInteractionText TextBlock; ; )
+void UInteractionFileLoader::LoadInteractionDocumentAsync( UObject *const WorldContextObject, const FName FileName, FInteractionDocument &Document,
+                                                           const FLatentActionInfo LatentInfo ) NoExcept
+{
+  AddLoadAction( WorldContextObject, FileName, Document, LatentInfo );
+}
+
+void UInteractionFileLoader::PinInteractionFile( const FName FileName ) NoExcept
+{
+  FInteractionFileCache::Get().Pin( FileName );
+}
+
+void UInteractionFileLoader::UnpinInteractionFile( const FName FileName ) NoExcept
+{
+  FInteractionFileCache::Get().Unpin( FileName );
+}
+
+FInteractionText UInteractionFileLoader::LoadInteractionBlock( const FName FileName, const int32 Index ) NoExcept
+{
+  TArray< FInteractionText > TextBlocks = LoadInteractionRange( FileName, Index, 1 );
+
+  DebugAssert( TextBlocks.Num() == 0, "Block %i is out of range in the file '%s'!", return FInteractionText{}, Index, *FileName.ToString() )
+
+  return std::move( TextBlocks[ 0 ] );
+}
+
+TArray< FInteractionText > UInteractionFileLoader::LoadInteractionRange( const FName FileName, const int32 First, const int32 Count ) NoExcept
+{
+  DebugAssert( First < 0 || Count < 0, "Invalid block range %i, %i!", return TArray< FInteractionText >{}, First, Count )
+
+  // Already loaded, just copy out the blocks
+  if( const FInteractionFileCache::FTextBlocksPtr Cached = FInteractionFileCache::Get().Find( FileName ) ) return Cached->CopyBlocks( First, Count );
+
+  // Archived and cooked files are opened once and kept in the cache, so later ranges don't decompress or map them again
+  if( FInteractionTextArchive::Get().Contains( FileName ) || FCookedInteractionFile::IsCooked( FileName ) )
   {
-    // TODO: the sectioning character is technically hardcoded and could change, easy fix though (could be replace by a markup, or just a constexpr)
+    return FInteractionFileCache::Get().Load( FileName )->CopyBlocks( First, Count );
+  }
+
+  // Only read and parse the bytes of the blocks that were asked for
+  int64 Begin, End;
+
+  if( !( FInteractionBlockIndex::Get().GetByteRange( FileName, First, Count, Begin, End ) ) ) return TArray< FInteractionText >{};
+
+  const FString FilePath = GetInteractionFilePath( FileName );
+
+  std::string Text( static_cast< size_t >( End - Begin ), '\0' );
+
+  FInteractionTextStats::FRecord Record;
+
+  {
+    SCOPE_CYCLE_COUNTER( STAT_InteractionText_Read );
+
+    const FInteractionTextStats::FPhaseScope Timer{ Record.ReadCycles };
+
+    std::ifstream InputFile{ *FilePath, std::ifstream::binary };
 
-    const size_t NextIndex = FullText.find( '\n', TextIndex ); // We are sectioning blocks off by the newline
+    DebugAssert( !( InputFile.is_open() ), "Unable to open file '%s'!", return TArray< FInteractionText >{}, *FilePath )
 
-    // Check if there is any text left
-    if( NextIndex == std::string::npos ) break;
+    InputFile.seekg( Begin, std::ifstream::beg );
+
+    if( Text.size() ) InputFile.read( &( Text.front() ), Text.size() );
+  }
+
+  Record.Loads     = 1;
+  Record.BytesRead = static_cast< int64 >( Text.size() );
+
+  FInteractionTextStats::Get().Add( FileName, Record );
+
+  return ParseInteractionText( Text.data(), Text.size(), FileName );
+}
+
+FInteractionDocument::FTextBlocksPtr UInteractionFileLoader::ReadInteractionFile( const FName FileName ) NoExcept
+{
+  const FString FilePath = GetInteractionFilePath( FileName );
+
+  FInteractionTextStats::FRecord Record;
+
+  Record.Loads = 1;
+
+  // Cooked files are already parsed and kept open, so only fall back to the markup when there isn't one
+  {
+    TUniquePtr< FCookedInteractionFile > CookedFile;
 
-    // Get the the block of text to check for markups
     {
-      size_t PrevIndex = 0;
-      
-      const std::string Text = FullText.substr( TextIndex, NextIndex - TextIndex );
+      SCOPE_CYCLE_COUNTER( STAT_InteractionText_Read );
 
-      // Start the markup loop
-      {
-        size_t Index = 0;
+      const FInteractionTextStats::FPhaseScope Timer{ Record.ReadCycles };
 
-        // Find the first markup, if any
-        while( ( Index = Text.find( '<', Index ) ) != std::string::npos )
-        {
-          if( Index ) // Make sure we have a normal string, the first part could be all marked up!
-          {
-            // Push back the not marked-up string
-            TextBlock.Text.Emplace( Text.substr( PrevIndex, Index - PrevIndex ).c_str() ); // Conversion from char* to FString
-            TextBlock.TextMarkup.Add( "Regular" );
-          }
-
-          int32 Bitmask = 0; // Used to know what markups are being applied to the strings
-
-        // Get the markups for the string
-        StartMarkup:
-          do // There might be multiple markups
-          {
-            // TODO: Replace the switch with the more dynamic array version to make it easier to add/remove markups
-            //       It's also faster but uses more memory
-
-            switch( Text[ Index + 1 ] ) // Set the markup bits
-            {
-              case static_cast< int >( FInteractionText::ETextMarkup::Bold ):
-                Bitmask |= FInteractionText::Bold;
-                break;
-
-              case static_cast< int >( FInteractionText::ETextMarkup::Italic ):
-                Bitmask |= FInteractionText::Italic;
-                break;
-
-              case static_cast< int >( FInteractionText::ETextMarkup::StrikeThrough ):
-                Bitmask |= FInteractionText::StrikeThrough;
-                break;
-
-              case static_cast< int >( FInteractionText::ETextMarkup::Underline ):
-                Bitmask |= FInteractionText::Underline;
-                break;
-
-              default:
-              {
-                ANSICHAR AnsiName[ NAME_SIZE ];
-
-                FileName.GetPlainANSIString( AnsiName );
-
-                DebugLogType( "Unknown markup '%c' in the file '%s'!", Error, Text[ Index + 1 ], AnsiName );
-              }
-            }
-
-            // TODO: Currently hardcoded, but would need to change a lot if the markups became more then two letters anyways. (The switch for example)
-            Index += 3; // Move over to the next markup, each is three characters: <x>
-          }
-          while( Text[ Index ] == '<' ); // While there are markups side-by-side
-
-        // Add the string and its markups
-        StartString:
-          PrevIndex = Index; // Save the index to get the substring
-
-          Index = Text.find( '<', Index + 1 );
-
-          // Push back the text with the current bitmask
-          TextBlock.Text.Emplace( Text.substr( PrevIndex, Index - PrevIndex ).c_str() );
-
-          // Parse through the set markups
-          {
-            FString FontMarkup;
-            size_t i = 0;
-
-            // Check to see which markups were set
-            for( ; /* We know there is always one possible markup, or this file would be useless */ ; )
-            {
-              // Check if the text has a markup
-              if( Bitmask & ( 1 << i ) ) 
-              {
-                // Add the first markup
-                FontMarkup.Append( FInteractionText::MarkupStrings[ i ] );
-
-                // Add the rest of the markups, this allows us to not add an extra space
-                for( ; ++i < FInteractionText::MaxMaskCount; )
-                {
-                  if( Bitmask & ( 1 << i ) )
-                  {
-                    FontMarkup.Append( " " );
-                    FontMarkup.Append( FInteractionText::MarkupStrings[ i ] );
-                  }
-                }
-
-                break;
-              }
-
-              if( ++i == FInteractionText::MaxMaskCount ) break;
-            }
-
-            TextBlock.TextMarkup.Add( FontMarkup );
-          }
-
-          // Unset markups, jump to adding more markups, or jump to add more strings
-          for( ; /* we know there is at least one bit set in the mask */ ; )
-          {
-            // If there is not an end markup, but another beginning we start over, adding to the current Bitmask
-            // EXAMPLE: <B><I>ABCD<U>EFGH</U></B>IJKL</I>
-            //          ABCD is bold and italic. EFGH is bold, italic, and underlined. IJKL is italic.
-
-            if( Text[ Index + 1 ] != '/' ) goto StartMarkup; // Start parsing the markups again
-
-            switch( Text[ Index + 2 ] ) // Unset the markup bits
-            {
-              case static_cast< int >( FInteractionText::ETextMarkup::Bold ) :
-                Bitmask &= ~( FInteractionText::Bold );
-                break;
-
-              case static_cast< int >( FInteractionText::ETextMarkup::Italic ):
-                Bitmask &= ~( FInteractionText::Italic );
-                break;
-
-              case static_cast< int >( FInteractionText::ETextMarkup::StrikeThrough ):
-                Bitmask &= ~( FInteractionText::StrikeThrough );
-                break;
-
-              case static_cast< int >( FInteractionText::ETextMarkup::Underline ):
-                Bitmask &= ~( FInteractionText::Underline );
-                break;
-
-              default:
-              {
-                ANSICHAR AnsiName[ NAME_SIZE ];
-
-                FileName.GetPlainANSIString( AnsiName );
-
-                DebugLogType( "Unknown markup '%c' in the file '%s'!", Error, Text[ Index + 1 ], AnsiName );
-              }
-            }
-
-            Index += 4; // Move over to the next end markup, each one is four characters: </x>
-
-            if( Bitmask ) // Loop while there are masks left, otherwise break and continue with a normal string. (No markups)
-            {
-              // If its not a markup character, its another string.
-              if( Text[ Index ] != '<' ) goto StartString; // Go back and add it, with the current state of the Bitmask
-            }
-            else break;
-          }
-
-          PrevIndex = Index;
-        } // Text while loop
-      } // End markup scope
-
-      // Add the last string to the text block
+      CookedFile = FInteractionTextArchive::Get().Open( FileName );
+
+      if( !CookedFile )
       {
-        const std::string LastString = Text.substr( PrevIndex );
+        CookedFile = MakeUnique< FCookedInteractionFile >();
 
-        // Check if there is any text left and push that back too
-        if( LastString.size() ) // This makes sure we don't add an empty string
-        {
-          TextBlock.Text.Emplace( LastString.c_str() );
-          TextBlock.TextMarkup.Add( "Regular" ); // It should not be marked up
-        }
+        if( !( CookedFile->Open( FileName ) ) ) CookedFile.Reset();
       }
-    } // End text scope
+    }
 
-    // Move the block, allowing us to not have to fully reconstruct another one
-    TextBlocks.Add( std::move( TextBlock ) );
+    if( CookedFile )
+    {
+      Record.Blocks = CookedFile->GetBlockCount();
+      Record.Runs   = CookedFile->GetRunCount();
+
+      FInteractionTextStats::Get().Add( FileName, Record );
 
-    TextIndex = NextIndex + 1; // Have to move over one character to not find it again
-  } // TextBlock loop 
+      return MakeShared< const FInteractionTextBlocks, ESPMode::ThreadSafe >( MoveTemp( CookedFile ) );
+    }
+  }
 
-  return TextBlocks;
+  TArray< uint8 > FullText; // Wholes all of the text from the file
+
+  // Load the file, in binary like every other reader so a '\r' before each newline is always there for the parser to drop
+  {
+    SCOPE_CYCLE_COUNTER( STAT_InteractionText_Read );
+
+    const FInteractionTextStats::FPhaseScope Timer{ Record.ReadCycles };
+
+    DebugAssert( !( FFileHelper::LoadFileToArray( FullText, *FilePath ) ), "Unable to open file '%s'!", return nullptr, *FilePath )
+  }
+
+  Record.BytesRead = FullText.Num();
+
+  FInteractionTextStats::Get().Add( FileName, Record ); // The parse adds its own phases
+
+  return MakeShared< const FInteractionTextBlocks, ESPMode::ThreadSafe >(
+           ParseInteractionText( reinterpret_cast< const char* >( FullText.GetData() ), FullText.Num(), FileName ) );
 }
 
+namespace
+{
+  void LogUnknownMarkup( const TCHAR *const Begin, const TCHAR *const End, FInteractionTextStats::FRecord &Record, const FName FileName ) NoExcept
+  {
+    DebugLogType( "Unknown markup '%.*s' in the file '%s'!", Error, static_cast< int >( End - Begin ), Begin, *FileName.ToString() );
+
+    ++( Record.UnknownMarkups );
+  }
+
+  // Gives the runs from InteractionMarkup::ParseBlock to the single block being built.
+  // The text is packed into Scratch, the run offsets are into it. The runs are only interned once the block is done.
+  struct FBlockSink
+  {
+    void AddRun( const TCHAR *const RunText, const int Length, const int Markup, const int Parameter ) NoExcept
+    {
+      const int32 Offset = Scratch.Num();
+
+      Scratch.Append( RunText, Length ); // The text was already decoded, so it is only a copy
+
+      Runs.Add( { Offset, Length, Markup, Parameter } );
+    }
+
+    void OnUnknownMarkup( const TCHAR *const Begin, const TCHAR *const End ) NoExcept
+    {
+      LogUnknownMarkup( Begin, End, Record, FileName );
+    }
+
+    TArray< InteractionMarkup::FRun > &Runs;
+
+    TArray< TCHAR > &Scratch;
+
+    FInteractionTextStats::FRecord &Record;
+
+    const FName FileName;
+  };
+
+  // Parses the block starting at RunStart into TextBlock, replacing what it had. Returns its newline, or End if it was never ended.
+  // Scratch and ScratchRuns are only used while the block is built, they are reused so they only grow a few times.
+  const TCHAR *ParseBlock( const TCHAR *const RunStart, const TCHAR *const End, FInteractionText &TextBlock, TArray< TCHAR > &Scratch,
+                           TArray< InteractionMarkup::FRun > &ScratchRuns, FInteractionTextStats::FRecord &Record, const FName FileName ) NoExcept
+  {
+    TextBlock.Runs.Reset();
+    Scratch.Reset();
+    ScratchRuns.Reset();
+
+    FBlockSink Sink{ ScratchRuns, Scratch, Record, FileName };
+
+    const TCHAR *BlockEnd;
+
+    {
+      SCOPE_CYCLE_COUNTER( STAT_InteractionText_Tokenize );
+
+      const FInteractionTextStats::FPhaseScope Timer{ Record.TokenizeCycles };
+
+      InteractionMarkup::TDelimiterScanner< TCHAR > Scanner{ End };
+
+      BlockEnd = InteractionMarkup::ParseBlock( RunStart, End, Scanner, Sink );
+    }
+
+    SCOPE_CYCLE_COUNTER( STAT_InteractionText_BuildRuns );
+
+    const FInteractionTextStats::FPhaseScope Timer{ Record.BuildRunsCycles };
+
+    // A closed and reopened markup, or an unknown one, splits the text without changing the markups
+    const int32 RunCount = CVarCoalesceRuns.GetValueOnAnyThread() ? InteractionMarkup::CoalesceRuns( ScratchRuns.GetData(), ScratchRuns.Num() )
+                                                                  : ScratchRuns.Num();
+
+    TextBlock.Runs.Reserve( RunCount );
+
+    for( int32 i = 0; i < RunCount; ++i )
+    {
+      const InteractionMarkup::FRun &Iter = ScratchRuns[ i ];
+
+      TextBlock.AddRun( Scratch.GetData() + Iter.Offset, Iter.Length, Iter.Markup, Iter.Parameter );
+    }
+
+    return BlockEnd;
+  }
+
+  // Gives the blocks from InteractionMarkup::TBlockParser to the FInteractionText being built, timing each phase of the parse
+  struct FBlockBuilder
+  {
+    void OnUnknownMarkup( const TCHAR *const Begin, const TCHAR *const End ) NoExcept
+    {
+      LogUnknownMarkup( Begin, End, Record, FileName );
+    }
+
+    template < typename PhaseType >
+    void Tokenize( const PhaseType &Phase ) NoExcept
+    {
+      SCOPE_CYCLE_COUNTER( STAT_InteractionText_Tokenize );
+
+      const FInteractionTextStats::FPhaseScope Timer{ Record.TokenizeCycles };
+
+      Phase();
+    }
+
+    template < typename PhaseType >
+    void Build( const PhaseType &Phase ) NoExcept
+    {
+      SCOPE_CYCLE_COUNTER( STAT_InteractionText_BuildRuns );
+
+      const FInteractionTextStats::FPhaseScope Timer{ Record.BuildRunsCycles };
+
+      Phase();
+    }
+
+    // Only the final blocks are allocated, each gets an exact sized array of its runs and each run's text is interned
+    void AddBlock( const TCHAR *const Text, const int, const InteractionMarkup::FRun *const Runs, const int RunCount ) NoExcept
+    {
+      FInteractionText &TextBlock = TextBlocks[ TextBlocks.AddDefaulted() ];
+
+      TextBlock.Runs.Reserve( RunCount );
+
+      for( int32 i = 0; i < RunCount; ++i ) TextBlock.AddRun( Text + Runs[ i ].Offset, Runs[ i ].Length, Runs[ i ].Markup, Runs[ i ].Parameter );
+    }
+
+    TArray< FInteractionText > &TextBlocks;
+
+    FInteractionTextStats::FRecord &Record;
+
+    const FName FileName;
+  };
+
+  // Every block is parsed in one sweep over the text
+  TArray< FInteractionText > ParseBlocks( const TCHAR *const Text, const TCHAR *const TextEnd, FInteractionTextStats::FRecord &Record,
+                                         const FName FileName ) NoExcept
+  {
+    // All of the blocks of text, each one has an array of text to render for that block and the markups for the text.
+    TArray< FInteractionText > TextBlocks;
+
+    FBlockBuilder Builder{ TextBlocks, Record, FileName };
+
+    InteractionMarkup::TBlockParser< TCHAR > Parser; // Its tables are reused for every batch, so they only grow a few times
+
+    Parser.Parse( Text, TextEnd, CVarCoalesceRuns.GetValueOnAnyThread() != 0, Builder );
+
+    return TextBlocks; // NRVO
+  }
+
+  // Decodes the UTF-8 text into Scratch, returning the end of the decoded text
+  const TCHAR *DecodeText( const char *const Text, const size_t Size, TArray< TCHAR > &Scratch, FInteractionTextStats::FRecord &Record ) NoExcept
+  {
+    SCOPE_CYCLE_COUNTER( STAT_InteractionText_Convert );
+
+    const FInteractionTextStats::FPhaseScope Timer{ Record.ConvertCycles };
+
+    Scratch.SetNumUninitialized( static_cast< int32 >( Size ), false ); // Never more characters than bytes
+
+    return Scratch.GetData() + InteractionMarkup::DecodeUtf8( Text, Size, Scratch.GetData() );
+  }
+}
+
+void UInteractionFileLoader::ParseInteractionBlock( const char *const Text, const size_t Size, FInteractionText &TextBlock, const FName FileName ) NoExcept
+{
+  // Called for every block while streaming, so don't allocate each time
+  thread_local TArray< TCHAR > Decoded;
+  thread_local TArray< TCHAR > Scratch;
+
+  thread_local TArray< InteractionMarkup::FRun > ScratchRuns;
+
+  FInteractionTextStats::FRecord Record;
+
+  const TCHAR *const DecodedEnd = DecodeText( Text, Size, Decoded, Record );
+
+  ParseBlock( Decoded.GetData(), DecodedEnd, TextBlock, Scratch, ScratchRuns, Record, FileName );
+
+  Record.Blocks = 1;
+  Record.Runs   = TextBlock.Runs.Num();
+
+  FInteractionTextStats::Get().Add( FileName, Record );
+}
+
+TArray< FInteractionText > UInteractionFileLoader::ParseInteractionText( const char *const Text, const size_t Size, const FName FileName ) NoExcept
+{
+  TArray< TCHAR > Decoded;
+
+  FInteractionTextStats::FRecord Record;
+
+  const TCHAR *const TextEnd     = DecodeText( Text, Size, Decoded, Record );
+  const TCHAR *const DecodedText = Decoded.GetData();
+
+  const size_t Threshold = static_cast< size_t >( FMath::Max( CVarParallelParseKB.GetValueOnAnyThread(), 0 ) ) * 1024;
+
+  const int32 ChunkCount = FMath::Min( FTaskGraphInterface::Get().GetNumWorkerThreads() + 1, static_cast< int32 >( Size / MinParallelChunkSize ) );
+
+  if( !Threshold || Size < Threshold || ChunkCount < 2 )
+  {
+    TArray< FInteractionText > TextBlocks = ParseBlocks( DecodedText, TextEnd, Record, FileName );
+
+    FInteractionTextStats::CountBlocks( Record, TextBlocks );
+    FInteractionTextStats::Get().Add( FileName, Record );
+
+    return TextBlocks; // NRVO
+  }
+
+  // Markups never carry over to the next block, so the text can be split on any newline and each chunk parsed on its own
+  TArray< const TCHAR* > ChunkStarts;
+
+  ChunkStarts.Reserve( ChunkCount + 1 );
+
+  ChunkStarts.Add( DecodedText );
+
+  const ptrdiff_t Length = TextEnd - DecodedText;
+
+  for( int32 i = 1; i < ChunkCount; ++i )
+  {
+    const TCHAR *Split = FMath::Max( DecodedText + Length / ChunkCount * i, ChunkStarts.Last() );
+
+    while( Split != TextEnd && *Split != InteractionMarkup::BlockDelimiter ) ++Split;
+
+    if( Split == TextEnd ) break; // The rest of the text is a single block
+
+    ChunkStarts.Add( Split + 1 ); // The chunk starts after the newline
+  }
+
+  ChunkStarts.Add( TextEnd );
+
+  TArray< TArray< FInteractionText > > Chunks;
+  TArray< FInteractionTextStats::FRecord > ChunkRecords; // Each thread times its own chunk
+
+  Chunks.SetNum( ChunkStarts.Num() - 1 );
+  ChunkRecords.SetNum( Chunks.Num() );
+
+  ParallelFor( Chunks.Num(), [ & ]( const int32 i )NoExcept->void
+  {
+    Chunks[ i ] = ParseBlocks( ChunkStarts[ i ], ChunkStarts[ i + 1 ], ChunkRecords[ i ], FileName );
+  } );
+
+  int32 BlockCount = 0;
+
+  for( const TArray< FInteractionText > &Iter : Chunks ) BlockCount += Iter.Num();
+
+  for( const FInteractionTextStats::FRecord &Iter : ChunkRecords ) Record += Iter;
+
+  // Stitch them back together in order
+  TArray< FInteractionText > TextBlocks = std::move( Chunks[ 0 ] );
+
+  {
+    SCOPE_CYCLE_COUNTER( STAT_InteractionText_BuildRuns );
+
+    const FInteractionTextStats::FPhaseScope Timer{ Record.BuildRunsCycles };
+
+    TextBlocks.Reserve( BlockCount );
+
+    for( int32 i = 1; i < Chunks.Num(); ++i )
+    {
+      for( FInteractionText &Iter : Chunks[ i ] ) TextBlocks.Add( std::move( Iter ) );
+    }
+  }
+
+  FInteractionTextStats::CountBlocks( Record, TextBlocks );
+  FInteractionTextStats::Get().Add( FileName, Record );
+
+  return TextBlocks; // NRVO
+}
+
+FString UInteractionFileLoader::GetInteractionFilePath( const FName FileName ) NoExcept
+{
+  return UKismetSystemLibrary::GetProjectContentDirectory() + "InteractionTextFiles/" + FileName.GetPlainNameString();
+}
+
+int32 UInteractionFileLoader::GetRunCount( const FInteractionText &TextBlock ) NoExcept
+{
+  return TextBlock.Runs.Num();
+}
+
+FString UInteractionFileLoader::GetRunText( const FInteractionText &TextBlock, const int32 Run ) NoExcept
+{
+  return TextBlock.GetRunText( Run );
+}
+
+FName UInteractionFileLoader::GetRunMarkup( const FInteractionText &TextBlock, const int32 Run ) NoExcept
+{
+  return FInteractionText::GetMarkupName( GetRunMarkupMask( TextBlock, Run ) );
+}
+
+int32 UInteractionFileLoader::GetRunMarkupMask( const FInteractionText &TextBlock, const int32 Run ) NoExcept
+{
+  DebugAssert( !( TextBlock.Runs.IsValidIndex( Run ) ), "Run %i is out of range, the block only has %i runs!", return 0,
+               Run, TextBlock.Runs.Num() )
+
+  return TextBlock.Runs[ Run ].Markup;
+}
+
+namespace
+{
+  // The <color=...> parameter is 0xRRGGBBAA
+  FLinearColor UnpackColor( const int32 Parameter ) NoExcept
+  {
+    const uint32 Packed = static_cast< uint32 >( Parameter );
+
+    return FLinearColor{ FColor{ static_cast< uint8 >( Packed >> 24 ), static_cast< uint8 >( Packed >> 16 ), static_cast< uint8 >( Packed >> 8 ),
+                                 static_cast< uint8 >( Packed ) } };
+  }
+}
+
+bool UInteractionFileLoader::GetRunColor( const FInteractionText &TextBlock, const int32 Run, FLinearColor &Color ) NoExcept
+{
+  if( !( GetRunMarkupMask( TextBlock, Run ) & FInteractionText::Color ) ) return false;
+
+  Color = UnpackColor( TextBlock.Runs[ Run ].Parameter );
+
+  return true;
+}
+
+bool UInteractionFileLoader::IsDocumentValid( const FInteractionDocument &Document ) NoExcept
+{
+  return Document.IsValid();
+}
+
+int32 UInteractionFileLoader::GetDocumentBlockCount( const FInteractionDocument &Document ) NoExcept
+{
+  return Document.Num();
+}
+
+FInteractionText UInteractionFileLoader::GetDocumentBlock( const FInteractionDocument &Document, const int32 Block ) NoExcept
+{
+  return GetDocumentBlockChecked( Document, Block ).ToText();
+}
+
+int32 UInteractionFileLoader::GetDocumentRunCount( const FInteractionDocument &Document, const int32 Block ) NoExcept
+{
+  return GetDocumentBlockChecked( Document, Block ).GetRunCount();
+}
+
+FString UInteractionFileLoader::GetDocumentRunText( const FInteractionDocument &Document, const int32 Block, const int32 Run ) NoExcept
+{
+  const FInteractionTextView TextBlock = GetDocumentBlockChecked( Document, Block );
+
+  return TextBlock.IsValid() ? TextBlock.GetRunString( Run ) : FString{};
+}
+
+FName UInteractionFileLoader::GetDocumentRunMarkup( const FInteractionDocument &Document, const int32 Block, const int32 Run ) NoExcept
+{
+  return FInteractionText::GetMarkupName( GetDocumentRunMarkupMask( Document, Block, Run ) );
+}
+
+int32 UInteractionFileLoader::GetDocumentRunMarkupMask( const FInteractionDocument &Document, const int32 Block, const int32 Run ) NoExcept
+{
+  const FInteractionTextView TextBlock = GetDocumentBlockChecked( Document, Block );
+
+  return TextBlock.IsValid() ? TextBlock.GetRunMarkup( Run ) : 0;
+}
+
+bool UInteractionFileLoader::GetDocumentRunColor( const FInteractionDocument &Document, const int32 Block, const int32 Run, FLinearColor &Color ) NoExcept
+{
+  const FInteractionTextView TextBlock = GetDocumentBlockChecked( Document, Block );
+
+  if( !( TextBlock.IsValid() ) || !( TextBlock.GetRunMarkup( Run ) & FInteractionText::Color ) ) return false;
+
+  Color = UnpackColor( TextBlock.GetRunParameter( Run ) );
+
+  return true;
+}
+
+FInteractionTextView UInteractionFileLoader::GetDocumentBlockChecked( const FInteractionDocument &Document, const int32 Block ) NoExcept
+{
+  const FInteractionTextView TextBlock = Document.GetBlock( Block );
+
+  DebugAssert( !( TextBlock.IsValid() ), "Block %i is out of range, the document only has %i blocks!", return FInteractionTextView{}, Block, Document.Num() )
+
+  return TextBlock;
+}
@@ -16,8 +16,13 @@
 
 // Unreal Includes
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "Engine/LatentActionManager.h" // FLatentActionInfo
+#include "Templates/UniquePtr.h"
 
 // Our Includes
+#include "Public/InteractionText/InteractionMarkupParser.h" // InteractionMarkup::FRun
+#include "Public/InteractionText/InteractionMarkupRegistry.h"
+#include "Public/InteractionText/InteractionStringTable.h"
 #include "Public/Utils/Macros.h"
 
 // STL Includes
@@ -25,45 +30,173 @@
 // This must be last
 #include "InteractionFileLoader.generated.h"
 
+// Commonly used forward declarations
+class FCookedInteractionFile;
+
 USTRUCT( BlueprintType, Category = "Interactions" )
 struct VIRIDIAN_API FInteractionText
 {
   GENERATED_BODY()
 
-  enum class ETextMarkup : int32
-  {
-    Bold = 'b',
-    Italic = 'i',
-    StrikeThrough = 's',
-    Underline = 'u',
-  };
+  public:
+    // A section of the block that shares the same markups
+    struct FRun
+    {
+      const TCHAR *GetData() const NoExcept { return Text.IsValid() ? Text->GetData() : nullptr; }
+
+      int32 Num() const NoExcept { return Text.IsValid() ? Text->Num() : 0; }
+
+      // Never changed once it is set, and shared through the FInteractionStringTable with the same text anywhere in any file
+      FInteractionStringTable::FStringPtr Text;
+
+      int32 Markup;    // Bitmask of the markups applied to the run
+      int32 Parameter; // The value of the run's markup with a parameter, such as the 0xRRGGBBAA of <color=...>. 0 if it has none.
+    };
 
   public:
     FInteractionText() NoExcept {}
 
-    FInteractionText( FInteractionText &&Move ) NoExcept;
+    FInteractionText( const FInteractionText &Copy ) NoExcept;
+    FInteractionText(       FInteractionText &&Move ) NoExcept;
 
   public:
     void operator=( const FInteractionText &Copy ) NoExcept;
     void operator=(       FInteractionText &&Move ) NoExcept;
 
   public:
-    static constexpr const char *const MarkupStrings[] = { "Bold", "Italic", "StrikeThrough", "Underline" };
+    // Adds a run with the interned copy of the text
+    void AddRun( const TCHAR *Text, int32 Length, int32 Markup, int32 Parameter ) NoExcept;
+
+    // Every run's text added together
+    int32 GetTextLength() const NoExcept;
+
+    FString GetRunText( int32 Run ) const NoExcept;
+
+    // Merges neighboring runs with the same markups and drops empty ones, so the block takes fewer draws to render.
+    // EXAMPLE: <b>AB</b><b>CD</b> is one bold run of ABCD. The parser only does this when Viridian.InteractionText.CoalesceRuns is 1.
+    void CoalesceRuns() NoExcept;
+
+    // The font name for the set markups, such as "Bold Italic", or "Regular" if there are none
+    static const FName &GetMarkupName( int32 Markup ) NoExcept;
+
+  public:
+    // Used to set bits for which markups a string contains, the bit is the markup's index in the InteractionMarkup::Markups registry.
+    // Shifting by the -1 of a missing tag is not a constant expression, so removing one from the registry fails to compile here.
+    static constexpr int32 Bold          = 1 << InteractionMarkup::IndexOf( "b"     );
+    static constexpr int32 Italic        = 1 << InteractionMarkup::IndexOf( "i"     );
+    static constexpr int32 StrikeThrough = 1 << InteractionMarkup::IndexOf( "s"     );
+    static constexpr int32 Underline     = 1 << InteractionMarkup::IndexOf( "u"     );
+    static constexpr int32 Wave          = 1 << InteractionMarkup::IndexOf( "wave"  );
+    static constexpr int32 Shake         = 1 << InteractionMarkup::IndexOf( "shake" );
+    static constexpr int32 Color         = 1 << InteractionMarkup::IndexOf( "color" ); // Its value is in the run's Parameter
+    static constexpr int32 MaxMaskCount  = InteractionMarkup::MarkupCount;
 
-    // Used to set bits for which markups a string contains
-    static constexpr size_t Bold          = 1 << 0;
-    static constexpr size_t Italic        = 1 << 1;
-    static constexpr size_t StrikeThrough = 1 << 2;
-    static constexpr size_t Underline     = 1 << 3;
-    static constexpr size_t MaxMaskCount  = sizeof( MarkupStrings ) / sizeof( *MarkupStrings );
+    static constexpr int32 MarkupCombinations = 1 << MaxMaskCount; // Every possible bitmask, each one has its own font name
 
   public:  
     // Unreal does not have the ability to render a line of text with multiple fonts, so we do multiple renders.
-    UPROPERTY( BlueprintReadOnly )
-    TArray< FString > Text; // The text to render, split into multiple string to handle font changes for markups.
+    // The block is split into a run for each font change from the markups, each run has its own interned text.
+    TArray< FRun > Runs; // In the order they should be rendered
+};
+
+// Reads one block in place, out of its FInteractionText or straight out of a cooked file's mapping, without copying or interning anything.
+// Only valid while the FInteractionTextBlocks it came from is, which the FInteractionDocument keeps alive.
+class VIRIDIAN_API FInteractionTextView
+{
+  public:
+    FInteractionTextView() NoExcept {}
+
+    explicit FInteractionTextView( const FInteractionText &TextBlock ) NoExcept : Parsed{ &TextBlock }, RunCount{ TextBlock.Runs.Num() } {}
+
+    // Offsets in the Runs are relative to the Text
+    FInteractionTextView( const TCHAR *Text, const InteractionMarkup::FRun *Runs, int32 Count ) NoExcept :
+    CookedText{ Text }, CookedRuns{ Runs }, RunCount{ Count } {}
+
+  public:
+    bool IsValid() const NoExcept { return Parsed || CookedText; }
+
+    int32 GetRunCount() const NoExcept { return RunCount; }
+
+    // Not null terminated, null if the run is out of range
+    const TCHAR *GetRunText( int32 Run, int32 &Length ) const NoExcept;
+
+    FString GetRunString( int32 Run ) const NoExcept;
 
-    UPROPERTY( BlueprintReadOnly )
-    TArray< FString > TextMarkup; // Each index has a corresponding element in the Text array
+    int32 GetRunMarkup   ( int32 Run ) const NoExcept;
+    int32 GetRunParameter( int32 Run ) const NoExcept;
+
+    // Every run's text added together
+    int32 GetTextLength() const NoExcept;
+
+    // Copies the block, interning the text of cooked runs
+    FInteractionText ToText() const NoExcept;
+
+  private:
+    const FInteractionText *Parsed = nullptr; // Null if cooked
+
+    const TCHAR                   *CookedText = nullptr;
+    const InteractionMarkup::FRun *CookedRuns = nullptr;
+
+    int32 RunCount = 0;
+};
+
+// Every block of a loaded file, never changed once it is made.
+// Cooked files keep their mapping, or the decompressed entry from the archive, open and are read in place, so loading one does not touch its text.
+class VIRIDIAN_API FInteractionTextBlocks
+{
+  public:
+    explicit FInteractionTextBlocks( TArray< FInteractionText > &&TextBlocks ) NoExcept;
+    explicit FInteractionTextBlocks( TUniquePtr< FCookedInteractionFile > &&CookedFile ) NoExcept;
+    ~FInteractionTextBlocks() NoExcept;
+
+  public:
+    int32 Num() const NoExcept;
+
+    bool IsValidIndex( int32 Block ) const NoExcept { return Block >= 0 && Block < Num(); }
+
+    // Invalid if the block is out of range
+    FInteractionTextView GetBlock( int32 Block ) const NoExcept;
+
+    // Count is clamped to the blocks in the file
+    TArray< FInteractionText > CopyBlocks( int32 First = 0, int32 Count = MAX_int32 ) const NoExcept;
+
+    // Includes the mapping of cooked files. Interned text is counted for every file that uses it, so the cache's budget is never underestimated.
+    int64 GetAllocatedSize() const NoExcept;
+
+  private:
+    TArray< FInteractionText > Parsed;
+
+    TUniquePtr< FCookedInteractionFile > Cooked; // Null if parsed
+};
+
+// A parsed interaction file that is shared instead of copied, copying the handle only adds a reference.
+// The blocks are never changed once parsed, so any number of widgets and threads can read the same document.
+USTRUCT( BlueprintType, Category = "Interactions" )
+struct VIRIDIAN_API FInteractionDocument
+{
+  GENERATED_BODY()
+
+  public:
+    using FTextBlocksRef = TSharedRef< const FInteractionTextBlocks, ESPMode::ThreadSafe >;
+    using FTextBlocksPtr = TSharedPtr< const FInteractionTextBlocks, ESPMode::ThreadSafe >;
+
+  public:
+    FInteractionDocument() NoExcept {}
+
+    explicit FInteractionDocument( const FTextBlocksPtr &Blocks ) NoExcept : TextBlocks{ Blocks } {}
+
+  public:
+    bool IsValid() const NoExcept { return TextBlocks.IsValid(); }
+
+    int32 Num() const NoExcept { return TextBlocks.IsValid() ? TextBlocks->Num() : 0; }
+
+    // Invalid if the block is out of range
+    FInteractionTextView GetBlock( int32 Block ) const NoExcept;
+
+    const FTextBlocksPtr &GetTextBlocks() const NoExcept { return TextBlocks; }
+
+  private:
+    FTextBlocksPtr TextBlocks; // Null until a file is loaded into it
 };
 
 UCLASS( Const )
@@ -72,8 +205,109 @@ class VIRIDIAN_API UInteractionFileLoader : public UBlueprintFunctionLibrary
   GENERATED_BODY()
 
   public:
-    // Returns a struct that contains an array of text.
-    // The struct has another array that determines any markups applied to each text element.
+    // Returns a struct for each block of text in the file.
+    // Each struct is split into runs of text, and each run has the markups applied to it.
+    // Files stay parsed in the FInteractionFileCache, so talking to the same NPC again does not re-read the file.
+    // The blocks are copied out of the cache, use LoadInteractionDocument to share them instead.
     UFUNCTION( BlueprintCallable, Category = "Interactions", meta = ( BlueprintThreadSafe ) )
     static TArray< FInteractionText > LoadInteractionFile( FName FileName ) NoExcept;
+
+    // Same as LoadInteractionFile, but the file is read and parsed on a background thread so opening a conversation does not hitch.
+    // Continues on the game thread once TextBlocks is filled. C++ can use FInteractionFileCache::LoadAsync instead.
+    UFUNCTION( BlueprintCallable, Category = "Interactions",
+               meta = ( Latent, LatentInfo = "LatentInfo", WorldContext = "WorldContextObject", DisplayName = "Load Interaction File Async" ) )
+    static void LoadInteractionFileAsync( UObject *WorldContextObject, FName FileName, TArray< FInteractionText > &TextBlocks,
+                                          FLatentActionInfo LatentInfo ) NoExcept;
+
+    // Returns a handle to the cached file, copying it around does not copy any text
+    UFUNCTION( BlueprintCallable, Category = "Interactions", meta = ( BlueprintThreadSafe ) )
+    static FInteractionDocument LoadInteractionDocument( FName FileName ) NoExcept;
+
+    // Same as LoadInteractionDocument, but the file is read and parsed on a background thread
+    UFUNCTION( BlueprintCallable, Category = "Interactions",
+               meta = ( Latent, LatentInfo = "LatentInfo", WorldContext = "WorldContextObject", DisplayName = "Load Interaction Document Async" ) )
+    static void LoadInteractionDocumentAsync( UObject *WorldContextObject, FName FileName, FInteractionDocument &Document,
+                                              FLatentActionInfo LatentInfo ) NoExcept;
+
+    // Returns a single block of the file, only that block is parsed unless the whole file is already cached
+    UFUNCTION( BlueprintCallable, Category = "Interactions", meta = ( BlueprintThreadSafe ) )
+    static FInteractionText LoadInteractionBlock( FName FileName, int32 Index ) NoExcept;
+
+    // Returns Count blocks starting at First, fewer if the file ends first. Only those blocks are parsed, or copied out of the cooked file.
+    UFUNCTION( BlueprintCallable, Category = "Interactions", meta = ( BlueprintThreadSafe ) )
+    static TArray< FInteractionText > LoadInteractionRange( FName FileName, int32 First, int32 Count ) NoExcept;
+
+    // Keeps the file in the cache until it is unpinned, loading it if it is not already
+    UFUNCTION( BlueprintCallable, Category = "Interactions", meta = ( BlueprintThreadSafe ) )
+    static void PinInteractionFile( FName FileName ) NoExcept;
+
+    // Lets the cache evict the file again once every pin has been removed
+    UFUNCTION( BlueprintCallable, Category = "Interactions", meta = ( BlueprintThreadSafe ) )
+    static void UnpinInteractionFile( FName FileName ) NoExcept;
+
+    // Opens the cooked file, or parses the markup if there isn't one. Skips the cache.
+    // Returns null if the file could not be read, so a missing file is not mistaken for an empty one.
+    static FInteractionDocument::FTextBlocksPtr ReadInteractionFile( FName FileName ) NoExcept;
+
+    // Parses UTF-8 markup text into blocks, each '\n' ends a block. Shared by the loader and the cook commandlet.
+    // The whole text is decoded to TCHARs once up front, then every run is copied straight out of it.
+    static TArray< FInteractionText > ParseInteractionText( const char *Text, size_t Size, FName FileName ) NoExcept;
+
+    // Parses UTF-8 markup text as a single block into TextBlock, stopping early if there is a '\n'. Used by FInteractionFileStream.
+    // Anything TextBlock already had is replaced.
+    static void ParseInteractionBlock( const char *Text, size_t Size, FInteractionText &TextBlock, FName FileName ) NoExcept;
+
+    // Where the raw markup file is stored in the content directory
+    static FString GetInteractionFilePath( FName FileName ) NoExcept;
+
+    // How many separately rendered strings the block of text has
+    UFUNCTION( BlueprintPure, Category = "Interactions", meta = ( BlueprintThreadSafe ) )
+    static int32 GetRunCount( const FInteractionText &TextBlock ) NoExcept;
+
+    // The text to render for the run, use GetRunMarkup to know which font to render it with
+    UFUNCTION( BlueprintPure, Category = "Interactions", meta = ( BlueprintThreadSafe ) )
+    static FString GetRunText( const FInteractionText &TextBlock, int32 Run ) NoExcept;
+
+    // The markups applied to the run, such as "Bold Italic", or "Regular" if there are none
+    UFUNCTION( BlueprintPure, Category = "Interactions", meta = ( BlueprintThreadSafe ) )
+    static FName GetRunMarkup( const FInteractionText &TextBlock, int32 Run ) NoExcept;
+
+    // The bitmask of the markups applied to the run, cheaper to switch on than the name
+    UFUNCTION( BlueprintPure, Category = "Interactions", meta = ( BlueprintThreadSafe ) )
+    static int32 GetRunMarkupMask( const FInteractionText &TextBlock, int32 Run ) NoExcept;
+
+    // The color from <color=...>, returns false and leaves Color alone if the run has none
+    UFUNCTION( BlueprintPure, Category = "Interactions", meta = ( BlueprintThreadSafe ) )
+    static bool GetRunColor( const FInteractionText &TextBlock, int32 Run, FLinearColor &Color ) NoExcept;
+
+    // False until a file has been loaded into the document
+    UFUNCTION( BlueprintPure, Category = "Interactions", meta = ( BlueprintThreadSafe ) )
+    static bool IsDocumentValid( const FInteractionDocument &Document ) NoExcept;
+
+    UFUNCTION( BlueprintPure, Category = "Interactions", meta = ( BlueprintThreadSafe ) )
+    static int32 GetDocumentBlockCount( const FInteractionDocument &Document ) NoExcept;
+
+    // Copies a single block out of the document, for widgets that take an FInteractionText
+    UFUNCTION( BlueprintPure, Category = "Interactions", meta = ( BlueprintThreadSafe ) )
+    static FInteractionText GetDocumentBlock( const FInteractionDocument &Document, int32 Block ) NoExcept;
+
+    // Same as GetRunCount, GetRunText, GetRunMarkup, GetRunMarkupMask and GetRunColor, but read straight out of the document without copying the block
+    UFUNCTION( BlueprintPure, Category = "Interactions", meta = ( BlueprintThreadSafe ) )
+    static int32 GetDocumentRunCount( const FInteractionDocument &Document, int32 Block ) NoExcept;
+
+    UFUNCTION( BlueprintPure, Category = "Interactions", meta = ( BlueprintThreadSafe ) )
+    static FString GetDocumentRunText( const FInteractionDocument &Document, int32 Block, int32 Run ) NoExcept;
+
+    UFUNCTION( BlueprintPure, Category = "Interactions", meta = ( BlueprintThreadSafe ) )
+    static FName GetDocumentRunMarkup( const FInteractionDocument &Document, int32 Block, int32 Run ) NoExcept;
+
+    UFUNCTION( BlueprintPure, Category = "Interactions", meta = ( BlueprintThreadSafe ) )
+    static int32 GetDocumentRunMarkupMask( const FInteractionDocument &Document, int32 Block, int32 Run ) NoExcept;
+
+    UFUNCTION( BlueprintPure, Category = "Interactions", meta = ( BlueprintThreadSafe ) )
+    static bool GetDocumentRunColor( const FInteractionDocument &Document, int32 Block, int32 Run, FLinearColor &Color ) NoExcept;
+
+  private:
+    // Logs if the block is out of range
+    static FInteractionTextView GetDocumentBlockChecked( const FInteractionDocument &Document, int32 Block ) NoExcept;
 };
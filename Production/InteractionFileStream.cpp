@@ -0,0 +1,162 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionFileStream.cpp
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#include "Public/InteractionText/InteractionFileStream.h"
+
+// Our Includes
+#include "Public/InteractionText/InteractionMarkupScanner.h"
+#include "Public/InteractionText/InteractionTextArchive.h"
+
+// STL Includes
+#include <cstring> // memchr, memmove
+
+FInteractionFileStream::FInteractionFileStream( const FName Name, const int32 Size ) NoExcept :
+FileName{ Name }, ArchivedFile{ Name }, ChunkSize{ FMath::Max( Size, 1 ) }
+{
+  if( ArchivedFile.IsOpen() )
+  {
+    if( ArchivedFile.Num() >= static_cast< int64 >( sizeof( FCookedInteractionFile::FHeader ) ) &&
+        ArchivedFile.Read( 0, sizeof( FCookedInteractionFile::FHeader ), &ArchivedHeader ) &&
+        FCookedInteractionFile::IsHeaderValid( ArchivedHeader, ArchivedFile.Num(), *FileName.ToString() ) )
+    {
+      CookedBlock = 0;
+
+      return;
+    }
+
+    ArchivedFile.Close(); // Out of date, use the loose files instead
+  }
+
+  if( CookedFile.Open( FileName ) )
+  {
+    CookedBlock = 0;
+
+    return;
+  }
+
+  InputFile.open( *( UInteractionFileLoader::GetInteractionFilePath( FileName ) ), std::ifstream::binary );
+
+  DebugAssert( !( InputFile.is_open() ), "Unable to open file '%s'!", return, *( UInteractionFileLoader::GetInteractionFilePath( FileName ) ) )
+
+  Buffer.SetNumUninitialized( ChunkSize );
+}
+
+bool FInteractionFileStream::IsOpen() const NoExcept
+{
+  return CookedBlock >= 0 || InputFile.is_open();
+}
+
+bool FInteractionFileStream::Next( FInteractionText &TextBlock ) NoExcept
+{
+  TextBlock.Runs.Reset();
+
+  if( CookedBlock >= 0 )
+  {
+    if( ArchivedFile.IsOpen() ) return NextArchived( TextBlock );
+
+    if( CookedBlock >= CookedFile.GetBlockCount() ) return false;
+
+    TextBlock = CookedFile.GetBlock( CookedBlock++ ).ToText();
+
+    return true;
+  }
+
+  for( ; ; )
+  {
+    // Only search the text that was added since last time, a block can span many chunks
+    const char *const Newline = static_cast< const char* >( std::memchr( Buffer.GetData() + Scanned, InteractionMarkup::BlockDelimiter, End - Scanned ) );
+
+    if( Newline ) // The whole block is in the Buffer, so markups split between chunks are already joined back together
+    {
+      const int32 BlockEnd = static_cast< int32 >( Newline - Buffer.GetData() );
+
+      UInteractionFileLoader::ParseInteractionBlock( Buffer.GetData() + Begin, BlockEnd - Begin, TextBlock, FileName );
+
+      Begin = Scanned = BlockEnd + 1;
+
+      return true;
+    }
+
+    Scanned = End;
+
+    if( !( ReadChunk() ) ) return false; // Text after the last newline is not a full block
+  }
+}
+
+bool FInteractionFileStream::ForEachBlock( const FName FileName, const TFunctionRef< bool( FInteractionText &&TextBlock ) > Visit,
+                                           const int32 ChunkSize ) NoExcept
+{
+  FInteractionFileStream Stream{ FileName, ChunkSize };
+
+  if( !( Stream.IsOpen() ) ) return false;
+
+  for( FInteractionText TextBlock; Stream.Next( TextBlock ) && Visit( std::move( TextBlock ) ); ) {}
+
+  return true;
+}
+
+bool FInteractionFileStream::ReadChunk() NoExcept
+{
+  if( !( InputFile ) ) return false;
+
+  // Move the unparsed text to the front, then make sure there is room for a whole chunk after it
+  const int32 Unparsed = End - Begin;
+
+  if( Begin ) std::memmove( Buffer.GetData(), Buffer.GetData() + Begin, Unparsed );
+
+  Scanned -= Begin;
+  End      = Unparsed;
+  Begin    = 0;
+
+  if( Buffer.Num() - End < ChunkSize ) Buffer.SetNumUninitialized( End + ChunkSize ); // Only for blocks larger than the chunk size
+
+  InputFile.read( Buffer.GetData() + End, ChunkSize );
+
+  End += static_cast< int32 >( InputFile.gcount() );
+
+  return InputFile.gcount() > 0;
+}
+
+bool FInteractionFileStream::NextArchived( FInteractionText &TextBlock ) NoExcept
+{
+  using FHeader = FCookedInteractionFile::FHeader;
+  using FBlock  = FCookedInteractionFile::FBlock;
+  using FRun    = FCookedInteractionFile::FRun;
+
+  if( CookedBlock >= ArchivedHeader.BlockCount ) return false;
+
+  // Where each table starts in the cooked layout
+  const int64 BlocksStart = sizeof( FHeader );
+  const int64 RunsStart   = BlocksStart + ArchivedHeader.BlockCount * static_cast< int64 >( sizeof( FBlock ) );
+  const int64 CharsStart  = RunsStart   + ArchivedHeader.RunCount   * static_cast< int64 >( sizeof( FRun   ) );
+
+  FBlock Block;
+
+  DebugAssert( !( ArchivedFile.Read( BlocksStart + CookedBlock * static_cast< int64 >( sizeof( FBlock ) ), sizeof( FBlock ), &Block ) ) ||
+               !( FCookedInteractionFile::IsBlockValid( ArchivedHeader, Block ) ), "Block %i of the archived file '%s' is corrupt!",
+               return false, CookedBlock, *FileName.ToString() )
+
+  ArchivedRuns .SetNumUninitialized( Block.RunCount,  false );
+  ArchivedChars.SetNumUninitialized( Block.CharCount, false );
+
+  DebugAssert( !( ArchivedFile.Read( RunsStart + Block.FirstRun * static_cast< int64 >( sizeof( FRun ) ), Block.RunCount * static_cast< int64 >( sizeof( FRun ) ),
+                                     ArchivedRuns.GetData() ) ) ||
+               !( ArchivedFile.Read( CharsStart + Block.FirstChar * static_cast< int64 >( sizeof( TCHAR ) ), Block.CharCount * static_cast< int64 >( sizeof( TCHAR ) ),
+                                     ArchivedChars.GetData() ) ) ||
+               !( FCookedInteractionFile::AreRunsValid( Block, ArchivedRuns.GetData() ) ), "Block %i of the archived file '%s' is corrupt!",
+               return false, CookedBlock, *FileName.ToString() )
+
+  ++CookedBlock;
+
+  TextBlock = FInteractionTextView{ ArchivedChars.GetData(), ArchivedRuns.GetData(), Block.RunCount }.ToText();
+
+  return true;
+}
@@ -0,0 +1,79 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionFileStream.h
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#pragma once
+
+// Unreal Includes
+#include "CoreMinimal.h"
+
+// Our Includes
+#include "Public/InteractionText/CookedInteractionFile.h"
+#include "Public/InteractionText/InteractionFileLoader.h"
+#include "Public/InteractionText/InteractionTextArchive.h"
+#include "Public/Utils/Macros.h"
+
+// STL Includes
+#include <fstream>
+
+// Reads an interaction file one block at a time, for files too large to keep parsed all at once.
+// The markup is read in fixed size chunks, so memory stays around the chunk size plus the longest block no matter how large the file is.
+// Cooked files are read straight out of the cooked layout instead, and archived ones a chunk at a time. Nothing goes through the FInteractionFileCache.
+//
+// FInteractionFileStream Stream{ "Codex.txt" };
+// for( FInteractionText TextBlock; Stream.Next( TextBlock ); ) { ... }
+class VIRIDIAN_API FInteractionFileStream
+{
+  public:
+    static constexpr int32 DefaultChunkSize = 64 * 1024;
+
+  public:
+    explicit FInteractionFileStream( FName FileName, int32 ChunkSize = DefaultChunkSize ) NoExcept;
+
+  public:
+    bool IsOpen() const NoExcept;
+
+    // Replaces TextBlock with the next block, returns false once there are no full blocks left
+    bool Next( FInteractionText &TextBlock ) NoExcept;
+
+    // Calls Visit with every block in order, return false from Visit to stop early. Returns false if the file could not be opened.
+    static bool ForEachBlock( FName FileName, TFunctionRef< bool( FInteractionText &&TextBlock ) > Visit,
+                              int32 ChunkSize = DefaultChunkSize ) NoExcept;
+
+  private:
+    bool ReadChunk() NoExcept; // Returns false at the end of the file
+
+    bool NextArchived( FInteractionText &TextBlock ) NoExcept; // Validates each block as it is read
+
+  private:
+    const FName FileName;
+
+    FCookedInteractionFile CookedFile;
+
+    // Only decompresses the chunks the current block is in, so memory stays around a few chunks plus the largest block
+    FInteractionTextArchive::FReader ArchivedFile;
+
+    FCookedInteractionFile::FHeader ArchivedHeader{}; // Only read if the ArchivedFile is open
+
+    TArray< FCookedInteractionFile::FRun > ArchivedRuns;  // The current block's, reused for every block
+    TArray< TCHAR >                        ArchivedChars;
+
+    int32 CookedBlock = -1; // -1 if the markup is being parsed instead
+
+    std::ifstream InputFile;
+
+    TArray< char > Buffer; // Only holds the unparsed text, grows past the chunk size only for blocks that are larger than it
+
+    int32 ChunkSize;
+
+    int32 Begin   = 0; // Start of the unparsed text in the Buffer
+    int32 End     = 0; // End of the text read into the Buffer
+    int32 Scanned = 0; // Everything before this is known to not be a newline
+};
@@ -0,0 +1,337 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionMarkupParser.h
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#pragma once
+
+// This header does not use the engine so the parser can be benchmarked on its own, see Benchmarks/
+// UInteractionFileLoader wraps it with FInteractionText, everything else should go through the loader.
+
+// Our Includes
+#include "InteractionMarkupRegistry.h"
+#include "InteractionMarkupScanner.h"
+
+// STL Includes
+#include <utility> // std::pair
+#include <vector>
+
+namespace InteractionMarkup
+{
+  static constexpr char MarkupEndDelimiter = '>';
+  static constexpr char ClosingMarkup      = '/';
+  static constexpr char ParameterDelimiter = '=';
+  static constexpr char CarriageReturn     = '\r';
+
+  static constexpr int ParseBatchChars = 16 * 1024; // Blocks are parsed in batches of about this much text, small enough to stay in the cache
+
+  // A section of a block's text that shares the same markups
+  struct FRun
+  {
+    int Offset; // Index of the first character in the block's text
+    int Length;
+    int Markup;    // Bitmask of the markups applied to the run
+    int Parameter; // The value of the run's markup with a parameter, such as the 0xRRGGBBAA of <color=...>. 0 if it has none.
+  };
+
+  // Merges neighboring runs with the same markups and drops empty ones. Returns how many are left at the front.
+  // EXAMPLE: <b>AB</b><b>CD</b> is one bold run of ABCD.
+  inline int CoalesceRuns( FRun *const Runs, const int Count ) NoExcept
+  {
+    int Last = -1; // The run being merged into
+
+    for( int i = 0; i < Count; ++i )
+    {
+      const FRun Iter = Runs[ i ];
+
+      if( !( Iter.Length ) ) continue;
+
+      // Runs are only mergable if their text is next to each other, which is always true for parsed blocks
+      if( Last >= 0 && Runs[ Last ].Markup == Iter.Markup && Runs[ Last ].Parameter == Iter.Parameter &&
+          Runs[ Last ].Offset + Runs[ Last ].Length == Iter.Offset )
+      {
+        Runs[ Last ].Length += Iter.Length;
+      }
+      else Runs[ ++Last ] = Iter; // Never ahead of Iter, so nothing is overwritten before it is read
+    }
+
+    return Last + 1;
+  }
+
+  // The Sink is given the parsed runs, it needs:
+  //   void AddRun( const CharType *Text, int Length, int Markup, int Parameter ); // Markup is the bitmask of the markups applied to the run
+  //   void OnUnknownMarkup( const CharType *Begin, const CharType *End );
+
+  // Files saved with Windows line endings have a '\r' before every newline, it is not part of the block's text.
+  // Returns where the text from Begin to BlockEnd really ends.
+  template < typename CharType >
+  const CharType *TrimCarriageReturn( const CharType *const Begin, const CharType *const BlockEnd ) NoExcept
+  {
+    return BlockEnd != Begin && BlockEnd[ -1 ] == CarriageReturn ? BlockEnd - 1 : BlockEnd;
+  }
+
+  struct FNamedColor
+  {
+    const char *Name;
+    uint32_t    Color; // 0xRRGGBBAA
+  };
+
+  static constexpr FNamedColor NamedColors[] =
+  {
+    { "white",   0xFFFFFFFF },
+    { "black",   0x000000FF },
+    { "gray",    0x808080FF },
+    { "red",     0xFF0000FF },
+    { "green",   0x00FF00FF },
+    { "blue",    0x0000FFFF },
+    { "yellow",  0xFFFF00FF },
+    { "cyan",    0x00FFFFFF },
+    { "magenta", 0xFF00FFFF },
+  };
+
+  // True if the text [ Begin, End ) is exactly the Name
+  template < typename CharType >
+  bool TextEquals( const CharType *Begin, const CharType *const End, const char *Name ) NoExcept
+  {
+    for( ; Begin != End && *Name; ++Begin, ++Name )
+    {
+      if( static_cast< uint32_t >( *Begin ) != static_cast< uint8_t >( *Name ) ) return false;
+    }
+
+    return Begin == End && !( *Name );
+  }
+
+  // The value of a hex digit, or -1 if it is not one
+  template < typename CharType >
+  int HexDigit( const CharType Char ) NoExcept
+  {
+    if( Char >= '0' && Char <= '9' ) return Char - '0';
+    if( Char >= 'a' && Char <= 'f' ) return Char - 'a' + 10;
+    if( Char >= 'A' && Char <= 'F' ) return Char - 'A' + 10;
+
+    return -1;
+  }
+
+  // Reads #RRGGBB, #RRGGBBAA, or one of the NamedColors into Color as 0xRRGGBBAA. Returns false if it is none of them.
+  template < typename CharType >
+  bool ParseColor( const CharType *const Begin, const CharType *const End, int &Color ) NoExcept
+  {
+    const ptrdiff_t Length = End - Begin;
+
+    if( Length && *Begin == '#' )
+    {
+      if( Length != 7 && Length != 9 ) return false;
+
+      uint32_t Packed = 0;
+
+      for( const CharType *Iter = Begin + 1; Iter != End; ++Iter )
+      {
+        const int Digit = HexDigit( *Iter );
+
+        if( Digit < 0 ) return false;
+
+        Packed = Packed << 4 | static_cast< uint32_t >( Digit );
+      }
+
+      if( Length == 7 ) Packed = Packed << 8 | 0xFF; // Opaque if the alpha is left out
+
+      Color = static_cast< int >( Packed );
+
+      return true;
+    }
+
+    for( const FNamedColor &Iter : NamedColors )
+    {
+      if( TextEquals( Begin, End, Iter.Name ) )
+      {
+        Color = static_cast< int >( Iter.Color );
+
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // Reads the value of the markup with a parameter at Bit, returns false if the value is not valid for it
+  template < typename CharType >
+  bool ParseParameter( const int Bit, const CharType *const Begin, const CharType *const End, int &Parameter ) NoExcept
+  {
+    return Bit == IndexOf( "color" ) && ParseColor( Begin, End, Parameter );
+  }
+
+  // Applies the markup that starts at the '<' to the Bitmask and Parameter, returns where the text after it starts
+  template < typename CharType, typename SinkType >
+  const CharType *ParseMarkup( const CharType *const Markup, const CharType *const End, SinkType &Sink, int &Bitmask, int &Parameter ) NoExcept
+  {
+    const bool IsEndMarkup = Markup + 1 < End && Markup[ 1 ] == ClosingMarkup;
+
+    const CharType *const Name    = Markup + 1 + IsEndMarkup;
+    const CharType       *NameEnd = Name;
+
+    // Markup names are only a few characters, and they can't go past the end of the block
+    while( NameEnd < End && *NameEnd != MarkupEndDelimiter && *NameEnd != BlockDelimiter ) ++NameEnd;
+
+    if( NameEnd == End || *NameEnd != MarkupEndDelimiter ) // Never closed, keep the rest of the block as text so nothing is lost
+    {
+      Sink.OnUnknownMarkup( Markup, NameEnd );
+
+      Sink.AddRun( Markup, static_cast< int >( TrimCarriageReturn( Markup, NameEnd ) - Markup ), Bitmask, Parameter );
+
+      return NameEnd;
+    }
+
+    const CharType *TagEnd = Name; // Before the '=' of <tag=value>
+
+    while( TagEnd != NameEnd && *TagEnd != ParameterDelimiter ) ++TagEnd;
+
+    const int Bit = FMarkupRegistry::Get().Find( Name, TagEnd );
+
+    // Only opening a markup with a parameter takes a value, and it has to have one
+    const bool NeedsValue = Bit >= 0 && Markups[ Bit ].HasParameter && !IsEndMarkup;
+
+    int Value = 0;
+
+    if( Bit < 0 || NeedsValue != ( TagEnd != NameEnd ) || ( NeedsValue && !( ParseParameter( Bit, TagEnd + 1, NameEnd, Value ) ) ) )
+    {
+      Sink.OnUnknownMarkup( Markup, NameEnd + 1 );
+    }
+    else if( IsEndMarkup )
+    {
+      Bitmask &= ~( 1 << Bit );
+
+      if( Markups[ Bit ].HasParameter ) Parameter = 0; // They don't nest, closing one goes back to no value at all
+    }
+    else
+    {
+      Bitmask |= ( 1 << Bit );
+
+      if( NeedsValue ) Parameter = Value;
+    }
+
+    return NameEnd + 1;
+  }
+
+  // Parses the block starting at RunStart, only stopping on newlines and markups. Returns its newline, or End if it was never ended.
+  // EXAMPLE: <b><i>ABCD<u>EFGH</u></b>IJKL</i>
+  //          ABCD is bold and italic. EFGH is bold, italic, and underlined. IJKL is italic.
+  template < typename CharType, typename SinkType >
+  const CharType *ParseBlock( const CharType *RunStart, const CharType *const End, TDelimiterScanner< CharType > &Scanner,
+                              SinkType &Sink ) NoExcept
+  {
+    int Bitmask   = 0; // Used to know what markups are being applied to the strings, they never carry over to the next block
+    int Parameter = 0;
+
+    for( ; ; ) // RunStart is the start of the text that has not been pushed back yet
+    {
+      const CharType *const Delimiter = Scanner.Next( RunStart );
+
+      const bool IsBlockEnd = Delimiter == End || *Delimiter == BlockDelimiter;
+
+      const CharType *const RunEnd = IsBlockEnd ? TrimCarriageReturn( RunStart, Delimiter ) : Delimiter;
+
+      // Push back the text before the delimiter, markups side-by-side don't make empty strings
+      if( RunEnd != RunStart ) Sink.AddRun( RunStart, static_cast< int >( RunEnd - RunStart ), Bitmask, Parameter );
+
+      if( IsBlockEnd ) return Delimiter;
+
+      RunStart = ParseMarkup( Delimiter, End, Sink, Bitmask, Parameter );
+    }
+  }
+
+  // Parses every full block of a text in one sweep, text after the last newline is not a full block.
+  // Blocks are tokenized a batch at a time into tables that stay in the cache, then the whole batch is built.
+  // Reuse the parser for every text on a thread, the tables only grow a few times.
+  //
+  // The Builder is given the parsed blocks, it needs:
+  //   void OnUnknownMarkup( const CharType *Begin, const CharType *End );
+  //   void Tokenize( Phase ) and void Build( Phase ); // Must call Phase(), so the caller can time each phase
+  //   void AddBlock( const CharType *Text, int Length, const FRun *Runs, int RunCount ); // The run offsets are into Text
+  template < typename CharType >
+  class TBlockParser
+  {
+    public:
+      template < typename BuilderType >
+      void Parse( const CharType *const Text, const CharType *const TextEnd, const bool Coalesce, BuilderType &Builder ) NoExcept
+      {
+        FSink< BuilderType > Sink{ *this, Builder };
+
+        TDelimiterScanner< CharType > Scanner{ TextEnd };
+
+        for( const CharType *BlockStart = Text; BlockStart; )
+        {
+          Scratch.clear();
+          Runs.clear();
+          BlockStarts.clear();
+
+          Builder.Tokenize( [ & ]()NoExcept->void
+          {
+            do
+            {
+              BlockStarts.emplace_back( static_cast< int >( Runs.size() ), static_cast< int >( Scratch.size() ) );
+
+              const CharType *const BlockEnd = ParseBlock( BlockStart, TextEnd, Scanner, Sink );
+
+              // Text after the last newline is not a full block, have to move over the newline to not find it again
+              BlockStart = BlockEnd == TextEnd ? nullptr : BlockEnd + 1;
+            }
+            while( BlockStart && Scratch.size() < ParseBatchChars );
+
+            // Where the next batch starts, or where the text after the last newline starts, is where the last full block ends
+            if( BlockStart ) BlockStarts.emplace_back( static_cast< int >( Runs.size() ), static_cast< int >( Scratch.size() ) );
+          } );
+
+          Builder.Build( [ & ]()NoExcept->void
+          {
+            for( size_t i = 0; i + 1 < BlockStarts.size(); ++i )
+            {
+              const int FirstRun  = BlockStarts[ i ].first;
+              const int FirstChar = BlockStarts[ i ].second;
+
+              FRun *const BlockRuns = Runs.data() + FirstRun;
+
+              // A closed and reopened markup, or an unknown one, splits the text without changing the markups
+              const int RunCount = Coalesce ? CoalesceRuns( BlockRuns, BlockStarts[ i + 1 ].first - FirstRun ) : BlockStarts[ i + 1 ].first - FirstRun;
+
+              for( int Run = 0; Run < RunCount; ++Run ) BlockRuns[ Run ].Offset -= FirstChar; // Into the block's own text
+
+              Builder.AddBlock( Scratch.data() + FirstChar, BlockStarts[ i + 1 ].second - FirstChar, BlockRuns, RunCount );
+            }
+          } );
+        }
+      }
+
+    private:
+      // Packs the text of the batch's runs into the Scratch, the run offsets are into it
+      template < typename BuilderType >
+      struct FSink
+      {
+        void AddRun( const CharType *const Text, const int Length, const int Markup, const int Parameter ) NoExcept
+        {
+          const int Offset = static_cast< int >( Parser.Scratch.size() );
+
+          Parser.Scratch.insert( Parser.Scratch.end(), Text, Text + Length ); // The text was already decoded, so it is only a copy
+          Parser.Runs.push_back( { Offset, Length, Markup, Parameter } );
+        }
+
+        void OnUnknownMarkup( const CharType *const Begin, const CharType *const End ) NoExcept
+        {
+          Builder.OnUnknownMarkup( Begin, End );
+        }
+
+        TBlockParser &Parser;
+        BuilderType  &Builder;
+      };
+
+    private:
+      std::vector< CharType >              Scratch;     // The text of the batch's blocks, packed together
+      std::vector< FRun >                  Runs;        // The batch's runs, the offsets are into Scratch
+      std::vector< std::pair< int, int > > BlockStarts; // The first run and character of each block in the batch
+  };
+}
@@ -0,0 +1,145 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionMarkupRegistry.h
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#pragma once
+
+// This header does not use the engine so the parser can be benchmarked on its own, see Benchmarks/
+
+// STL Includes
+#include <cstdint>
+#include <cstring> // memset, strlen
+
+#ifndef NoExcept
+  #define NoExcept noexcept // Macros.h is not included when building without the engine
+#endif
+
+namespace InteractionMarkup
+{
+  struct FMarkupInfo
+  {
+    const char *Tag;          // What is written between the '<' and '>'
+    const char *StyleName;    // Used to build the font name, such as "Bold Italic". Null if the markup does not change the font.
+    bool        HasParameter; // Opened as <tag=value>, the value is kept in the run's Parameter
+  };
+
+  // Every markup the interaction files can use, the index is the markup's bit in the bitmask.
+  // To add a markup just add it here, nothing in the parser has to change unless it has a parameter.
+  // There can be at most 8, every combination of them gets a font name.
+  static constexpr FMarkupInfo Markups[] =
+  {
+    { "b",     "Bold",          false },
+    { "i",     "Italic",        false },
+    { "s",     "StrikeThrough", false },
+    { "u",     "Underline",     false },
+    { "wave",  "Wave",          false },
+    { "shake", "Shake",         false },
+    { "color", nullptr,         true  }, // <color=#RRGGBB>, <color=#RRGGBBAA> or <color=red>, see ParseColor
+  };
+
+  static constexpr int MarkupCount = sizeof( Markups ) / sizeof( *Markups );
+
+  static_assert( MarkupCount <= 8, "Every combination of markups gets a font name, more than 8 markups would be over 256 fonts!" );
+
+  constexpr int CountParameters( const int Index = 0 ) NoExcept
+  {
+    return Index == MarkupCount ? 0 : Markups[ Index ].HasParameter + CountParameters( Index + 1 );
+  }
+
+  static_assert( CountParameters() <= 1, "Runs only have one Parameter, two markups with parameters would overwrite each other's!" );
+
+  // Compares two tags at compile time
+  constexpr bool TagEquals( const char *const Lhs, const char *const Rhs ) NoExcept
+  {
+    return *Lhs == *Rhs && ( !( *Lhs ) || TagEquals( Lhs + 1, Rhs + 1 ) );
+  }
+
+  // The bit index of the markup with the Tag, or -1 if there isn't one. Used to name the bits without repeating the registry's order.
+  constexpr int IndexOf( const char *const Tag, const int Index = 0 ) NoExcept
+  {
+    return Index == MarkupCount ? -1 : TagEquals( Markups[ Index ].Tag, Tag ) ? Index : IndexOf( Tag, Index + 1 );
+  }
+
+  // Finds which markup a tag is in constant time, no matter how many markups there are.
+  // Each tag is hashed into a 256 entry table, the seed is picked when the registry is built so no two tags collide.
+  class FMarkupRegistry
+  {
+    public:
+      static const FMarkupRegistry &Get() NoExcept
+      {
+        static const FMarkupRegistry Registry; // Built once, the first time a markup is parsed
+
+        return Registry;
+      }
+
+    public:
+      // Returns the bit index of the markup named [ Name, NameEnd ), or -1 if there isn't one.
+      // CharType is char for raw UTF-8 and TCHAR for decoded text.
+      template < typename CharType >
+      int Find( const CharType *const Name, const CharType *const NameEnd ) const NoExcept
+      {
+        const int Index = static_cast< int >( Table[ Hash( Name, NameEnd, Seed ) ] ) - 1;
+
+        // The hash only narrows it down to one markup, an unknown tag can still land on it
+        if( Index < 0 || static_cast< size_t >( NameEnd - Name ) != TagLengths[ Index ] ) return -1;
+
+        for( size_t i = 0; i < TagLengths[ Index ]; ++i )
+        {
+          if( static_cast< uint32_t >( Name[ i ] ) != static_cast< uint8_t >( Markups[ Index ].Tag[ i ] ) ) return -1;
+        }
+
+        return Index;
+      }
+
+    private:
+      FMarkupRegistry() NoExcept
+      {
+        for( int i = 0; i < MarkupCount; ++i ) TagLengths[ i ] = std::strlen( Markups[ i ].Tag );
+
+        // With this few markups in 256 slots the first seed almost always works
+        for( Seed = 0; !( TryBuild() ); ++Seed ) {}
+      }
+
+      bool TryBuild() NoExcept
+      {
+        std::memset( Table, 0, sizeof( Table ) );
+
+        for( int i = 0; i < MarkupCount; ++i )
+        {
+          uint8_t &Slot = Table[ Hash( Markups[ i ].Tag, Markups[ i ].Tag + TagLengths[ i ], Seed ) ];
+
+          if( Slot ) return false; // Collision, try the next seed
+
+          Slot = static_cast< uint8_t >( i + 1 );
+        }
+
+        return true;
+      }
+
+      // FNV-1a folded down to a byte, tags are only a few characters.
+      // Only the low byte of each character is hashed, so a tag hashes the same no matter how wide its characters are.
+      template < typename CharType >
+      static uint8_t Hash( const CharType *Begin, const CharType *const End, const uint32_t Seed ) NoExcept
+      {
+        uint32_t Value = 2166136261u ^ Seed;
+
+        for( ; Begin != End; ++Begin ) Value = ( Value ^ static_cast< uint8_t >( *Begin ) ) * 16777619u;
+
+        return static_cast< uint8_t >( Value ^ ( Value >> 8 ) ^ ( Value >> 16 ) ^ ( Value >> 24 ) );
+      }
+
+    private:
+      uint8_t Table[ 256 ]; // Markup index + 1, 0 if empty
+
+      size_t TagLengths[ MarkupCount ];
+
+      uint32_t Seed;
+  };
+}
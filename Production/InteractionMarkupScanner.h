@@ -0,0 +1,214 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionMarkupScanner.h
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#pragma once
+
+// This header does not use the engine so the scanner can be benchmarked on its own, see Benchmarks/
+
+// STL Includes
+#include <cstddef>
+#include <cstdint>
+#include <type_traits> // std::integral_constant
+
+#if defined( __AVX2__ )
+  #include <immintrin.h>
+
+  #define INTERACTION_SCANNER_AVX2 1
+  #define INTERACTION_SCANNER_SSE2 1 // Wide characters still use the SSE2 path, AVX2 packs within each 128 bit lane
+#elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+  #include <emmintrin.h>
+
+  #define INTERACTION_SCANNER_SSE2 1
+#endif
+
+#if defined( _MSC_VER )
+  #include <intrin.h> // _BitScanForward
+#endif
+
+#ifndef NoExcept
+  #define NoExcept noexcept // Macros.h is not included when building without the engine
+#endif
+
+namespace InteractionMarkup
+{
+  // Both characters the parser has to stop on, blocks are ended by the newline and markups start with '<'
+  static constexpr char BlockDelimiter  = '\n';
+  static constexpr char MarkupDelimiter = '<';
+
+  inline unsigned CountTrailingZeros( const uint64_t Mask ) NoExcept
+  {
+#if defined( _MSC_VER ) && defined( _M_X64 )
+    unsigned long Index;
+
+    _BitScanForward64( &Index, Mask );
+
+    return static_cast< unsigned >( Index );
+#elif defined( _MSC_VER )
+    unsigned long Index;
+
+    if( _BitScanForward( &Index, static_cast< uint32_t >( Mask ) ) ) return static_cast< unsigned >( Index );
+
+    _BitScanForward( &Index, static_cast< uint32_t >( Mask >> 32 ) );
+
+    return static_cast< unsigned >( Index ) + 32;
+#else
+    return static_cast< unsigned >( __builtin_ctzll( Mask ) );
+#endif
+  }
+
+  // One character at a time, used for the end of the text and on platforms without SIMD
+  template < typename CharType >
+  inline const CharType *FindDelimiterScalar( const CharType *Begin, const CharType *const End ) NoExcept
+  {
+    for( ; Begin != End; ++Begin )
+    {
+      if( *Begin == BlockDelimiter || *Begin == MarkupDelimiter ) return Begin;
+    }
+
+    return End;
+  }
+
+  // Finds every '\n' and '<' in the text in a single sweep, both are checked at once 64 characters at a time.
+  // The positions of a whole stride are kept as a bitmask, so asking for the next one is usually just a bit scan.
+  // CharType is char for raw UTF-8 and TCHAR for decoded text, 1, 2, and 4 byte characters are all vectorized.
+  template < typename CharType >
+  class TDelimiterScanner
+  {
+    public:
+      static constexpr ptrdiff_t StrideSize = 64; // One bit per character in the Mask
+
+    public:
+      explicit TDelimiterScanner( const CharType *const TextEnd ) NoExcept : End{ TextEnd } {}
+
+    public:
+      // Returns the first delimiter at or after From, or End if there are none. From can never move backwards.
+      const CharType *Next( const CharType *From ) NoExcept
+      {
+#if INTERACTION_SCANNER_SSE2
+        for( ; ; )
+        {
+          if( Stride && From < Stride + StrideSize ) // Still inside the stride we already classified
+          {
+            const uint64_t Remaining = Mask & ( ~uint64_t{ 0 } << ( From - Stride ) ); // Skip anything before From
+
+            if( Remaining ) return Stride + CountTrailingZeros( Remaining );
+
+            From = Stride + StrideSize;
+          }
+
+          if( End - From < StrideSize ) break; // Not enough left for a full stride
+
+          Stride = From;
+          Mask   = Classify( From, std::integral_constant< size_t, sizeof( CharType ) >{} );
+        }
+#endif
+
+        return FindDelimiterScalar( From, End );
+      }
+
+    private:
+#if INTERACTION_SCANNER_AVX2
+      static uint64_t Classify( const CharType *const Text, std::integral_constant< size_t, 1 > ) NoExcept
+      {
+        const __m256i Newlines = _mm256_set1_epi8( BlockDelimiter );
+        const __m256i Markups  = _mm256_set1_epi8( MarkupDelimiter );
+
+        const __m256i Low  = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( Text ) );
+        const __m256i High = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( Text + 32 ) );
+
+        const uint32_t LowMask  = static_cast< uint32_t >( _mm256_movemask_epi8( _mm256_or_si256( _mm256_cmpeq_epi8( Low,  Newlines ),
+                                                                                                  _mm256_cmpeq_epi8( Low,  Markups ) ) ) );
+        const uint32_t HighMask = static_cast< uint32_t >( _mm256_movemask_epi8( _mm256_or_si256( _mm256_cmpeq_epi8( High, Newlines ),
+                                                                                                  _mm256_cmpeq_epi8( High, Markups ) ) ) );
+
+        return static_cast< uint64_t >( HighMask ) << 32 | LowMask;
+      }
+#elif INTERACTION_SCANNER_SSE2
+      static uint64_t Classify( const CharType *const Text, std::integral_constant< size_t, 1 > ) NoExcept
+      {
+        const __m128i Newlines = _mm_set1_epi8( BlockDelimiter );
+        const __m128i Markups  = _mm_set1_epi8( MarkupDelimiter );
+
+        uint64_t Mask = 0;
+
+        for( int i = 0; i < 4; ++i )
+        {
+          const __m128i Chars = _mm_loadu_si128( reinterpret_cast< const __m128i* >( Text + i * 16 ) );
+
+          const uint64_t Found = static_cast< uint32_t >( _mm_movemask_epi8( _mm_or_si128( _mm_cmpeq_epi8( Chars, Newlines ),
+                                                                                           _mm_cmpeq_epi8( Chars, Markups ) ) ) );
+
+          Mask |= Found << ( i * 16 );
+        }
+
+        return Mask;
+      }
+#endif
+
+#if INTERACTION_SCANNER_SSE2
+      // Each compare is packed down to a byte per character so the movemask still gives one bit per character
+      static uint64_t Classify( const CharType *const Text, std::integral_constant< size_t, 2 > ) NoExcept
+      {
+        const __m128i Newlines = _mm_set1_epi16( BlockDelimiter );
+        const __m128i Markups  = _mm_set1_epi16( MarkupDelimiter );
+
+        uint64_t Mask = 0;
+
+        for( int i = 0; i < 4; ++i )
+        {
+          const __m128i Low  = _mm_loadu_si128( reinterpret_cast< const __m128i* >( Text + i * 16 ) );
+          const __m128i High = _mm_loadu_si128( reinterpret_cast< const __m128i* >( Text + i * 16 + 8 ) );
+
+          const __m128i Packed = _mm_packs_epi16( _mm_or_si128( _mm_cmpeq_epi16( Low,  Newlines ), _mm_cmpeq_epi16( Low,  Markups ) ),
+                                                  _mm_or_si128( _mm_cmpeq_epi16( High, Newlines ), _mm_cmpeq_epi16( High, Markups ) ) );
+
+          Mask |= static_cast< uint64_t >( static_cast< uint32_t >( _mm_movemask_epi8( Packed ) ) ) << ( i * 16 );
+        }
+
+        return Mask;
+      }
+
+      static uint64_t Classify( const CharType *const Text, std::integral_constant< size_t, 4 > ) NoExcept
+      {
+        const __m128i Newlines = _mm_set1_epi32( BlockDelimiter );
+        const __m128i Markups  = _mm_set1_epi32( MarkupDelimiter );
+
+        uint64_t Mask = 0;
+
+        for( int i = 0; i < 4; ++i )
+        {
+          __m128i Found[ 4 ];
+
+          for( int j = 0; j < 4; ++j )
+          {
+            const __m128i Chars = _mm_loadu_si128( reinterpret_cast< const __m128i* >( Text + i * 16 + j * 4 ) );
+
+            Found[ j ] = _mm_or_si128( _mm_cmpeq_epi32( Chars, Newlines ), _mm_cmpeq_epi32( Chars, Markups ) );
+          }
+
+          const __m128i Packed = _mm_packs_epi16( _mm_packs_epi32( Found[ 0 ], Found[ 1 ] ), _mm_packs_epi32( Found[ 2 ], Found[ 3 ] ) );
+
+          Mask |= static_cast< uint64_t >( static_cast< uint32_t >( _mm_movemask_epi8( Packed ) ) ) << ( i * 16 );
+        }
+
+        return Mask;
+      }
+#endif
+
+    private:
+      const CharType *const End;
+
+      const CharType *Stride = nullptr; // Start of the last classified stride
+      uint64_t        Mask   = 0;       // Bit i is set if Stride[ i ] is a delimiter
+  };
+
+  using FDelimiterScanner = TDelimiterScanner< char >;
+}
@@ -0,0 +1,121 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionStringTable.cpp
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#include "Public/InteractionText/InteractionStringTable.h"
+
+// Unreal Includes
+#include "HAL/IConsoleManager.h"
+#include "Misc/Crc.h"
+#include "Misc/ScopeLock.h"
+
+static TAutoConsoleVariable< int32 > CVarInternText( TEXT( "Viridian.InteractionText.InternText" ), 1,
+                                                     TEXT( "Share the text of identical interaction blocks between files, 0 disables it." ) );
+
+static FAutoConsoleCommand InternStatsCommand( TEXT( "Viridian.InteractionText.InternStats" ),
+                                               TEXT( "Prints how much memory sharing identical interaction text has saved." ),
+                                               FConsoleCommandDelegate::CreateLambda( []()NoExcept->void
+{
+  const FInteractionStringTable::FStats Stats = FInteractionStringTable::Get().GetStats();
+
+  DebugLogType( "Interned %lld strings, %.1f KB resident. %lld of %lld lookups were shared (%.1f%%), saving %.1f KB.", Display,
+                Stats.StringCount, Stats.ResidentBytes / 1024.0, Stats.Hits, Stats.Lookups,
+                Stats.Lookups ? 100.0 * Stats.Hits / Stats.Lookups : 0.0, Stats.SavedBytes / 1024.0 );
+} ) );
+
+static constexpr int32 SweepInterval = 1024; // Adds to a shard before its freed strings are removed
+
+FInteractionStringTable &FInteractionStringTable::Get() NoExcept
+{
+  static FInteractionStringTable Table;
+
+  return Table;
+}
+
+FInteractionStringTable::FStringRef FInteractionStringTable::Intern( const TCHAR *const Text, const int32 Length ) NoExcept
+{
+  if( !( CVarInternText.GetValueOnAnyThread() ) ) return MakeString( Text, Length );
+
+  const int64 Bytes = Length * sizeof( TCHAR );
+
+  const uint32 Hash = FCrc::MemCrc32( Text, static_cast< int32 >( Bytes ) );
+
+  FShard &Shard = Shards[ Hash % ShardCount ];
+
+  Lookups.Increment();
+
+  FScopeLock ScopeLock{ &( Shard.Lock ) };
+
+  // CRCs can collide, so every string with the same one is compared
+  for( auto Iter = Shard.Strings.CreateKeyIterator( Hash ); Iter; ++Iter )
+  {
+    const FStringPtr String = Iter.Value().String.Pin();
+
+    if( String.IsValid() && String->Num() == Length && !( FMemory::Memcmp( String->GetData(), Text, Bytes ) ) )
+    {
+      Hits.Increment();
+      SavedBytes.Add( Bytes );
+
+      return String.ToSharedRef();
+    }
+  }
+
+  if( ++( Shard.AddsSinceSweep ) >= SweepInterval ) Sweep( Shard );
+
+  const FStringRef String = MakeString( Text, Length );
+
+  Shard.Strings.Add( Hash, FEntry{ String, Length } );
+
+  StringCount.Increment();
+  ResidentBytes.Add( Bytes );
+
+  return String;
+}
+
+FInteractionStringTable::FStats FInteractionStringTable::GetStats() NoExcept
+{
+  for( FShard &Iter : Shards )
+  {
+    FScopeLock ScopeLock{ &( Iter.Lock ) };
+
+    Sweep( Iter );
+  }
+
+  FStats Stats;
+
+  Stats.Lookups       = Lookups.GetValue();
+  Stats.Hits          = Hits.GetValue();
+  Stats.SavedBytes    = SavedBytes.GetValue();
+  Stats.StringCount   = StringCount.GetValue();
+  Stats.ResidentBytes = ResidentBytes.GetValue();
+
+  return Stats; // NRVO
+}
+
+FInteractionStringTable::FStringRef FInteractionStringTable::MakeString( const TCHAR *const Text, const int32 Length ) NoExcept
+{
+  // The array and the reference count share one allocation, the text is the only other one
+  return MakeShared< TArray< TCHAR >, ESPMode::ThreadSafe >( Text, Length );
+}
+
+void FInteractionStringTable::Sweep( FShard &Shard ) NoExcept
+{
+  for( auto Iter = Shard.Strings.CreateIterator(); Iter; ++Iter )
+  {
+    if( Iter.Value().String.IsValid() ) continue;
+
+    StringCount.Decrement();
+    ResidentBytes.Subtract( Iter.Value().Length * sizeof( TCHAR ) );
+
+    Iter.RemoveCurrent();
+  }
+
+  Shard.AddsSinceSweep = 0;
+}
@@ -0,0 +1,87 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionStringTable.h
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#pragma once
+
+// Unreal Includes
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/ThreadSafeCounter64.h"
+
+// Our Includes
+#include "Public/Utils/Macros.h"
+
+// Shares the text of identical runs between every interaction file, such as greetings, button prompts, and barks.
+// Each run's text is interned once its block is built, so a line used by a hundred NPCs is only stored once.
+// Strings are freed once no run uses them, the table only keeps weak references.
+// Every function is safe to call from any thread. Print the savings with "Viridian.InteractionText.InternStats".
+class VIRIDIAN_API FInteractionStringTable
+{
+  public:
+    // Interned text is never changed, so it can be shared between threads
+    using FStringRef = TSharedRef< const TArray< TCHAR >, ESPMode::ThreadSafe >;
+    using FStringPtr = TSharedPtr< const TArray< TCHAR >, ESPMode::ThreadSafe >;
+
+    struct FStats
+    {
+      int64 Lookups       = 0;
+      int64 Hits          = 0;
+      int64 SavedBytes    = 0; // Bytes that were not allocated because the text was already interned, since startup
+      int64 StringCount   = 0; // Resident, only counting interned strings
+      int64 ResidentBytes = 0;
+    };
+
+  public:
+    static FInteractionStringTable &Get() NoExcept;
+
+  public:
+    // Returns the shared copy of the text, adding it if this is the first time it has been seen.
+    // Interning can be turned off with Viridian.InteractionText.InternText, then every call makes a new string.
+    FStringRef Intern( const TCHAR *Text, int32 Length ) NoExcept;
+
+    // Sweeps every shard first, freed strings are only taken out of the stats when they are swept
+    FStats GetStats() NoExcept;
+
+  private:
+    static constexpr int32 ShardCount = 16; // Loads on different threads rarely wait on the same lock
+
+    struct FEntry
+    {
+      TWeakPtr< const TArray< TCHAR >, ESPMode::ThreadSafe > String;
+
+      int32 Length; // Kept here, the string is already gone when the sweep takes it out of the stats
+    };
+
+    struct FShard
+    {
+      FCriticalSection Lock;
+
+      TMultiMap< uint32, FEntry > Strings; // Keyed by the CRC of the text
+
+      int32 AddsSinceSweep = 0;
+    };
+
+  private:
+    FInteractionStringTable() NoExcept {}
+
+    static FStringRef MakeString( const TCHAR *Text, int32 Length ) NoExcept;
+
+    void Sweep( FShard &Shard ) NoExcept; // Lock must be held
+
+  private:
+    FShard Shards[ ShardCount ];
+
+    FThreadSafeCounter64 Lookups;
+    FThreadSafeCounter64 Hits;
+    FThreadSafeCounter64 SavedBytes;
+    FThreadSafeCounter64 StringCount;
+    FThreadSafeCounter64 ResidentBytes;
+};
@@ -0,0 +1,338 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionTextArchive.cpp
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#include "Public/InteractionText/InteractionTextArchive.h"
+
+// Unreal Includes
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Kismet/KismetSystemLibrary.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+
+// Our Includes
+#include "Public/InteractionText/CookedInteractionFile.h"
+
+static const FName OodleFormat{ TEXT( "Oodle" ) }; // Only registered when the Oodle plugin is enabled
+
+FInteractionTextArchive &FInteractionTextArchive::Get() NoExcept
+{
+  static FInteractionTextArchive Archive;
+
+  return Archive;
+}
+
+FInteractionTextArchive::FInteractionTextArchive() NoExcept
+{
+  MappedFile.Reset( FPlatformFileManager::Get().GetPlatformFile().OpenMapped( *GetArchivePath() ) );
+
+  if( !MappedFile ) return; // No archive, everything is loaded from the loose files
+
+  MappedRegion.Reset( MappedFile->MapRegion( 0, MappedFile->GetFileSize() ) );
+
+  DebugAssert( !MappedRegion, "Unable to map the interaction text archive '%s'!", return, *GetArchivePath() )
+
+  const int64 Size = MappedRegion->GetMappedSize();
+
+  const FHeader *const Header = reinterpret_cast< const FHeader* >( MappedRegion->GetMappedPtr() );
+
+  if( Size < static_cast< int64 >( sizeof( FHeader ) ) ||
+      Header->Magic != Magic || Header->Version != Version || Header->CharSize != sizeof( TCHAR ) )
+  {
+    DebugLogType( "The interaction text archive is out of date, re-run the CookInteractionText commandlet with -archive!", Warning );
+
+    return;
+  }
+
+  DebugAssert( Header->FileCount < 0 || Header->ChunkCount < 0 || Header->ChunkSize <= 0 || Header->NameChars < 0,
+               "The interaction text archive is corrupt!", return )
+
+  const FChunk *const FileChunks  = reinterpret_cast< const FChunk* >( Header + 1 );
+  const FEntry *const FileEntries = reinterpret_cast< const FEntry* >( FileChunks + Header->ChunkCount );
+  const TCHAR  *const Names       = reinterpret_cast< const TCHAR*  >( FileEntries + Header->FileCount );
+
+  // In int64 so a corrupt count can't overflow past the check
+  const int64 PayloadStart = sizeof( FHeader ) + static_cast< int64 >( Header->ChunkCount ) * sizeof( FChunk ) +
+                             static_cast< int64 >( Header->FileCount ) * sizeof( FEntry ) + static_cast< int64 >( Header->NameChars ) * sizeof( TCHAR );
+
+  DebugAssert( PayloadStart > Size, "The interaction text archive is corrupt!", return )
+
+  for( const FChunk *Chunk = FileChunks; Chunk != FileChunks + Header->ChunkCount; ++Chunk )
+  {
+    const bool ChunkInBounds = Chunk->Offset >= PayloadStart && Chunk->CompressedSize >= 0 && Chunk->CompressedSize <= Size - Chunk->Offset &&
+                               Chunk->UncompressedSize >= 0 && Chunk->UncompressedSize <= Header->ChunkSize;
+
+    DebugAssert( !ChunkInBounds, "The interaction text archive is corrupt!", return )
+  }
+
+  Entries.Reserve( Header->FileCount );
+
+  for( int32 i = 0; i < Header->FileCount; ++i )
+  {
+    const FEntry &Entry = FileEntries[ i ];
+
+    const bool NameInBounds   = Entry.NameOffset >= 0 && Entry.NameLength >= 0 && Entry.NameLength <= Header->NameChars - Entry.NameOffset;
+    const bool ChunksInBounds = Entry.FirstChunk >= 0 && Entry.ChunkCount >= 0 && Entry.ChunkCount <= Header->ChunkCount - Entry.FirstChunk;
+
+    DebugAssert( !NameInBounds || !ChunksInBounds, "The interaction text archive is corrupt!", Entries.Empty(); return )
+
+    // Every chunk but the last is full, which is what the FReader uses to find the chunk an offset is in
+    int64 UncompressedSize = 0;
+
+    for( int32 Chunk = Entry.FirstChunk; Chunk < Entry.FirstChunk + Entry.ChunkCount; ++Chunk )
+    {
+      const bool IsLast = Chunk == Entry.FirstChunk + Entry.ChunkCount - 1;
+
+      DebugAssert( !IsLast && FileChunks[ Chunk ].UncompressedSize != Header->ChunkSize, "The interaction text archive is corrupt!", Entries.Empty(); return )
+
+      UncompressedSize += FileChunks[ Chunk ].UncompressedSize;
+    }
+
+    DebugAssert( UncompressedSize != Entry.UncompressedSize, "The interaction text archive is corrupt!", Entries.Empty(); return )
+
+    Entries.Add( FName{ Entry.NameLength, Names + Entry.NameOffset }, &Entry );
+  }
+
+  CompressionFormat = FName{ Header->CompressionFormat };
+
+  ChunkSize = Header->ChunkSize;
+
+  Data   = MappedRegion->GetMappedPtr();
+  Chunks = FileChunks;
+
+#if WITH_EDITOR
+  TimeStamp = IFileManager::Get().GetTimeStamp( *GetArchivePath() );
+#endif
+}
+
+FInteractionTextArchive::~FInteractionTextArchive() NoExcept
+{
+  Entries.Empty();
+
+  MappedRegion.Reset(); // The region has to go before the file it maps
+  MappedFile.Reset();
+}
+
+bool FInteractionTextArchive::Contains( const FName FileName ) const NoExcept
+{
+  if( !( Entries.Contains( FileName ) ) ) return false;
+
+#if WITH_EDITOR
+  // The writers could have changed the file since it was archived
+  if( IFileManager::Get().GetTimeStamp( *( UInteractionFileLoader::GetInteractionFilePath( FileName ) ) ) > TimeStamp ) return false;
+#endif
+
+  return true;
+}
+
+TUniquePtr< FCookedInteractionFile > FInteractionTextArchive::Open( const FName FileName ) const NoExcept
+{
+  TArray< uint8 > Data;
+
+  if( !( Decompress( FileName, Data ) ) ) return nullptr;
+
+  TUniquePtr< FCookedInteractionFile > CookedFile = MakeUnique< FCookedInteractionFile >();
+
+  if( !( CookedFile->Open( MoveTemp( Data ), *FileName.ToString() ) ) ) return nullptr;
+
+  return CookedFile;
+}
+
+bool FInteractionTextArchive::Decompress( const FName FileName, TArray< uint8 > &CookedFile ) const NoExcept
+{
+  if( !( Contains( FileName ) ) ) return false;
+
+  const FEntry &Entry = *( Entries[ FileName ] );
+
+  CookedFile.SetNumUninitialized( Entry.UncompressedSize, false ); // Don't shrink, the caller may be reusing it
+
+  uint8 *Dest = CookedFile.GetData();
+
+  for( const FChunk *Chunk = Chunks + Entry.FirstChunk; Chunk != Chunks + Entry.FirstChunk + Entry.ChunkCount; ++Chunk )
+  {
+    DebugAssert( !( DecompressChunk( *Chunk, Dest ) ), "Unable to decompress '%s' from the interaction text archive!", return false, *FileName.ToString() )
+
+    Dest += Chunk->UncompressedSize;
+  }
+
+  return true;
+}
+
+bool FInteractionTextArchive::DecompressChunk( const FChunk &Chunk, uint8 *const Dest ) const NoExcept
+{
+  return FCompression::UncompressMemory( CompressionFormat, Dest, Chunk.UncompressedSize, Data + Chunk.Offset, Chunk.CompressedSize );
+}
+
+FInteractionTextArchive::FReader::FReader( const FName FileName ) NoExcept
+{
+  const FInteractionTextArchive &Archive = FInteractionTextArchive::Get();
+
+  if( Archive.Contains( FileName ) ) Entry = Archive.Entries[ FileName ];
+}
+
+void FInteractionTextArchive::FReader::Close() NoExcept
+{
+  Entry = nullptr;
+
+  for( FSlot &Iter : Slots ) Iter = FSlot{};
+}
+
+bool FInteractionTextArchive::FReader::Read( const int64 Offset, const int64 Size, void *const Dest ) NoExcept
+{
+  DebugAssert( !Entry || Offset < 0 || Size < 0 || Size > Num() - Offset, "Reading %lld bytes at %lld is out of range!", return false, Size, Offset )
+
+  const int32 ChunkSize = FInteractionTextArchive::Get().ChunkSize;
+
+  uint8 *Write = static_cast< uint8* >( Dest );
+
+  // Only the chunks the range covers are decompressed, usually just one
+  for( int64 Position = Offset, End = Offset + Size; Position < End; )
+  {
+    const int32 Chunk      = static_cast< int32 >( Position / ChunkSize );
+    const int32 ChunkStart = static_cast< int32 >( Position % ChunkSize );
+    const int32 Count      = static_cast< int32 >( FMath::Min< int64 >( End - Position, ChunkSize - ChunkStart ) );
+
+    const uint8 *const ChunkData = GetChunk( Chunk );
+
+    if( !ChunkData ) return false;
+
+    FMemory::Memcpy( Write, ChunkData + ChunkStart, Count );
+
+    Write    += Count;
+    Position += Count;
+  }
+
+  return true;
+}
+
+const uint8 *FInteractionTextArchive::FReader::GetChunk( const int32 Chunk ) NoExcept
+{
+  FSlot *Oldest = Slots;
+
+  for( FSlot &Iter : Slots )
+  {
+    if( Iter.Chunk == Chunk )
+    {
+      Iter.LastUsed = ++UseCount;
+
+      return Iter.Data.GetData();
+    }
+
+    if( Iter.LastUsed < Oldest->LastUsed ) Oldest = &Iter;
+  }
+
+  // Reuses the least recently used slot's memory, so it never grows past a chunk
+  const FInteractionTextArchive &Archive = FInteractionTextArchive::Get();
+  const FChunk                  &Info    = Archive.Chunks[ Entry->FirstChunk + Chunk ];
+
+  Oldest->Data.SetNumUninitialized( Info.UncompressedSize, false );
+
+  if( !( Archive.DecompressChunk( Info, Oldest->Data.GetData() ) ) )
+  {
+    Oldest->Chunk = -1;
+
+    DebugLogType( "Unable to decompress a chunk from the interaction text archive!", Error );
+
+    return nullptr;
+  }
+
+  Oldest->Chunk    = Chunk;
+  Oldest->LastUsed = ++UseCount;
+
+  return Oldest->Data.GetData();
+}
+
+FString FInteractionTextArchive::GetArchivePath() NoExcept
+{
+  // Not next to the loose files, the commandlet and the hot reload watcher would parse it as one
+  return UKismetSystemLibrary::GetProjectContentDirectory() + "InteractionTextFiles/Cooked/InteractionText.archive";
+}
+
+bool FInteractionTextArchive::Write( const FString &Path, const TMap< FName, TArray< uint8 > > &CookedFiles, const int32 ChunkSize ) NoExcept
+{
+  DebugAssert( ChunkSize <= 0, "Invalid chunk size %i for the interaction text archive!", return false, ChunkSize )
+
+  const FName Format = FCompression::IsFormatValid( OodleFormat ) ? OodleFormat : NAME_LZ4;
+
+  FHeader Header;
+
+  FMemory::Memzero( Header ); // The padding is written too, keep the archive the same from cook to cook
+
+  Header.Magic     = Magic;
+  Header.Version   = Version;
+  Header.CharSize  = sizeof( TCHAR );
+  Header.FileCount = CookedFiles.Num();
+  Header.ChunkSize = ChunkSize;
+
+  FCString::Strncpy( Header.CompressionFormat, *Format.ToString(), ARRAY_COUNT( Header.CompressionFormat ) );
+
+  TArray< FChunk > FileChunks;
+  TArray< FEntry > FileEntries;
+  TArray< TCHAR >  Names;
+  TArray< uint8 >  Payloads;
+
+  FileEntries.Reserve( CookedFiles.Num() );
+
+  for( const auto &Iter : CookedFiles )
+  {
+    const FString Name = Iter.Key.ToString();
+
+    FEntry Entry{ Names.Num(), Name.Len(), FileChunks.Num(), 0, Iter.Value.Num() };
+
+    Names.Append( *Name, Name.Len() );
+
+    // Every chunk is compressed on its own, so the FReader can decompress any one of them without the ones before it
+    for( int32 Start = 0; Start < Iter.Value.Num(); Start += ChunkSize )
+    {
+      const int32 Count = FMath::Min( ChunkSize, Iter.Value.Num() - Start );
+
+      FChunk Chunk{ Payloads.Num(), FCompression::CompressMemoryBound( Format, Count ), Count };
+
+      Payloads.AddUninitialized( Chunk.CompressedSize );
+
+      if( !( FCompression::CompressMemory( Format, Payloads.GetData() + Chunk.Offset, Chunk.CompressedSize, Iter.Value.GetData() + Start, Count ) ) )
+      {
+        DebugLogType( "Unable to compress '%s' for the interaction text archive!", Error, *Name );
+
+        return false;
+      }
+
+      Payloads.SetNum( static_cast< int32 >( Chunk.Offset ) + Chunk.CompressedSize, false ); // Give back what the bound over-estimated
+
+      FileChunks.Add( Chunk );
+
+      ++( Entry.ChunkCount );
+    }
+
+    FileEntries.Add( Entry );
+  }
+
+  Header.ChunkCount = FileChunks.Num();
+  Header.NameChars  = Names.Num();
+
+  // Offsets were relative to the payloads, make them relative to the archive
+  const int64 PayloadStart = sizeof( FHeader ) + FileChunks.Num() * sizeof( FChunk ) + FileEntries.Num() * sizeof( FEntry ) + Names.Num() * sizeof( TCHAR );
+
+  for( FChunk &Iter : FileChunks ) Iter.Offset += PayloadStart;
+
+  TArray< uint8 > Archive;
+
+  Archive.Reserve( PayloadStart + Payloads.Num() );
+
+  Archive.Append( reinterpret_cast< const uint8* >( &Header ), sizeof( FHeader ) );
+  Archive.Append( reinterpret_cast< const uint8* >( FileChunks.GetData() ), FileChunks.Num() * sizeof( FChunk ) );
+  Archive.Append( reinterpret_cast< const uint8* >( FileEntries.GetData() ), FileEntries.Num() * sizeof( FEntry ) );
+  Archive.Append( reinterpret_cast< const uint8* >( Names.GetData() ), Names.Num() * sizeof( TCHAR ) );
+  Archive.Append( Payloads );
+
+  return FFileHelper::SaveArrayToFile( Archive, *Path );
+}
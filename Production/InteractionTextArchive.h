@@ -0,0 +1,159 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionTextArchive.h
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#pragma once
+
+// Unreal Includes
+#include "CoreMinimal.h"
+#include "Templates/UniquePtr.h"
+
+// Our Includes
+#include "Public/InteractionText/InteractionFileLoader.h"
+#include "Public/Utils/Macros.h"
+
+// Commonly used forward declarations
+class IMappedFileHandle;
+class IMappedFileRegion;
+class FCookedInteractionFile;
+
+// Every cooked interaction file packed into InteractionTextFiles/Cooked/InteractionText.archive, written by the CookInteractionText commandlet.
+// The archive is memory mapped once, so loading a file never opens or seeks a file handle.
+// Each file is split into ChunkSize chunks that are compressed on their own with Oodle when it is available, LZ4 otherwise.
+// Loading a file decompresses every chunk, the FReader only decompresses the chunks it reads so streaming a file never holds all of it.
+//
+// Layout:
+//   FHeader
+//   FChunk [ ChunkCount ] // Every file's chunks, in order
+//   FEntry [ FileCount  ]
+//   TCHAR  [ NameChars  ] // Every file name, back to back
+//   Compressed chunks
+class VIRIDIAN_API FInteractionTextArchive
+{
+  public:
+    static constexpr uint32 Magic   = 0x41544956; // "VITA"
+    static constexpr uint32 Version = 3;
+
+    static constexpr int32 DefaultChunkSize = 64 * 1024;
+
+    // Padded to 8 so the int64 in the FChunk right after it is aligned, whatever sizeof( TCHAR ) is
+    struct alignas( 8 ) FHeader
+    {
+      uint32 Magic;
+      uint32 Version;
+      uint32 CharSize;  // sizeof( TCHAR ) of the platform that cooked it
+      int32  FileCount;
+      int32  ChunkCount;
+      int32  ChunkSize; // Uncompressed, only the last chunk of a file is smaller
+      int32  NameChars;
+      TCHAR  CompressionFormat[ 16 ];
+    };
+
+    struct FChunk
+    {
+      int64 Offset; // From the start of the archive
+      int32 CompressedSize;
+      int32 UncompressedSize;
+    };
+
+    struct FEntry
+    {
+      int32 NameOffset; // Into the names
+      int32 NameLength;
+      int32 FirstChunk;
+      int32 ChunkCount;
+      int32 UncompressedSize;
+    };
+
+    static_assert( sizeof( FHeader ) % alignof( FChunk ) == 0, "The chunks after the FHeader would not be aligned!" );
+
+    // Reads parts of one file out of the archive, only decompressing the chunks that are read.
+    // A few decompressed chunks are kept, so reading the cooked blocks, runs and text in order decompresses each chunk about once.
+    class VIRIDIAN_API FReader
+    {
+      public:
+        // Not open if the archive does not have the file
+        explicit FReader( FName FileName ) NoExcept;
+
+      public:
+        bool IsOpen() const NoExcept { return Entry != nullptr; }
+
+        // Frees the decompressed chunks
+        void Close() NoExcept;
+
+        // The size of the decompressed file
+        int64 Num() const NoExcept { return Entry ? Entry->UncompressedSize : 0; }
+
+        // Copies Size bytes starting at Offset into Dest, returns false if they are out of range or a chunk could not be decompressed
+        bool Read( int64 Offset, int64 Size, void *Dest ) NoExcept;
+
+      private:
+        const uint8 *GetChunk( int32 Chunk ) NoExcept; // Null if it could not be decompressed
+
+      private:
+        static constexpr int32 SlotCount = 3; // One for each of the blocks, runs and text that the FInteractionFileStream reads
+
+        struct FSlot
+        {
+          int32 Chunk = -1; // Index into the file's chunks, -1 if empty
+          uint32 LastUsed = 0;
+
+          TArray< uint8 > Data;
+        };
+
+        const FEntry *Entry = nullptr;
+
+        FSlot Slots[ SlotCount ];
+
+        uint32 UseCount = 0;
+    };
+
+  public:
+    // The archive is mapped the first time it is used
+    static FInteractionTextArchive &Get() NoExcept;
+
+  public:
+    bool Contains( FName FileName ) const NoExcept;
+
+    // Decompresses the file into a cooked file that keeps the data, null if the archive does not have it
+    TUniquePtr< FCookedInteractionFile > Open( FName FileName ) const NoExcept;
+
+    // Decompresses every chunk of the cooked file into CookedFile
+    bool Decompress( FName FileName, TArray< uint8 > &CookedFile ) const NoExcept;
+
+  public:
+    static FString GetArchivePath() NoExcept;
+
+    // CookedFiles are from FCookedInteractionFile::Serialize
+    static bool Write( const FString &Path, const TMap< FName, TArray< uint8 > > &CookedFiles, int32 ChunkSize = DefaultChunkSize ) NoExcept;
+
+  private:
+    FInteractionTextArchive() NoExcept;
+    ~FInteractionTextArchive() NoExcept;
+
+    bool DecompressChunk( const FChunk &Chunk, uint8 *Dest ) const NoExcept;
+
+  private:
+    TUniquePtr< IMappedFileHandle > MappedFile;
+    TUniquePtr< IMappedFileRegion > MappedRegion; // Must be released before the MappedFile
+
+    const uint8  *Data   = nullptr;
+    const FChunk *Chunks = nullptr;
+
+    FName CompressionFormat;
+
+    int32 ChunkSize = 0;
+
+    TMap< FName, const FEntry* > Entries;
+
+#if WITH_EDITOR
+    FDateTime TimeStamp; // Loose files newer than the archive are used instead
+#endif
+};
@@ -0,0 +1,182 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionTextDecoder.h
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#pragma once
+
+// This header does not use the engine so the decoder can be benchmarked on its own, see Benchmarks/
+
+// Our Includes
+#include "InteractionMarkupScanner.h" // SIMD includes and CountTrailingZeros
+
+// STL Includes
+#include <cstddef>
+#include <cstdint>
+#include <type_traits> // std::conditional
+
+namespace InteractionMarkup
+{
+  static constexpr uint32_t ReplacementCharacter = 0xFFFD; // Written in place of anything that is not valid UTF-8
+
+  namespace Detail
+  {
+    // Writes the code point as UTF-16, or UTF-32 if the characters are 4 bytes. Returns how many characters were written.
+    template < typename CharType >
+    inline size_t WriteCodePoint( const uint32_t CodePoint, CharType *const Dest ) NoExcept
+    {
+      if( sizeof( CharType ) == 2 && CodePoint > 0xFFFF ) // Needs a surrogate pair
+      {
+        Dest[ 0 ] = static_cast< CharType >( 0xD800 + ( ( CodePoint - 0x10000 ) >> 10 ) );
+        Dest[ 1 ] = static_cast< CharType >( 0xDC00 + ( ( CodePoint - 0x10000 ) & 0x3FF ) );
+
+        return 2;
+      }
+
+      Dest[ 0 ] = static_cast< CharType >( CodePoint );
+
+      return 1;
+    }
+
+    // Decodes the multi-byte sequence at Text, moving Text past it. Invalid sequences only skip their first byte.
+    inline uint32_t DecodeSequence( const uint8_t *&Text, const uint8_t *const End ) NoExcept
+    {
+      const uint8_t Lead = *Text;
+
+      size_t   Length;
+      uint32_t CodePoint;
+      uint32_t Min; // Anything smaller is an overlong encoding
+
+      if     ( ( Lead & 0xE0 ) == 0xC0 ) { Length = 2; CodePoint = Lead & 0x1F; Min = 0x80;    }
+      else if( ( Lead & 0xF0 ) == 0xE0 ) { Length = 3; CodePoint = Lead & 0x0F; Min = 0x800;   }
+      else if( ( Lead & 0xF8 ) == 0xF0 ) { Length = 4; CodePoint = Lead & 0x07; Min = 0x10000; }
+      else
+      {
+        ++Text; // A stray continuation byte, or not UTF-8 at all
+
+        return ReplacementCharacter;
+      }
+
+      if( static_cast< size_t >( End - Text ) < Length )
+      {
+        ++Text;
+
+        return ReplacementCharacter;
+      }
+
+      for( size_t i = 1; i < Length; ++i )
+      {
+        if( ( Text[ i ] & 0xC0 ) != 0x80 )
+        {
+          ++Text;
+
+          return ReplacementCharacter;
+        }
+
+        CodePoint = CodePoint << 6 | ( Text[ i ] & 0x3F );
+      }
+
+      if( CodePoint < Min || CodePoint > 0x10FFFF || ( CodePoint >= 0xD800 && CodePoint <= 0xDFFF ) )
+      {
+        ++Text;
+
+        return ReplacementCharacter;
+      }
+
+      Text += Length;
+
+      return CodePoint;
+    }
+
+#if INTERACTION_SCANNER_AVX2 || INTERACTION_SCANNER_SSE2
+    // Widens 16 ASCII bytes, every high byte is zero
+    inline void WidenAscii( const __m128i Chars, char16_t *const Dest ) NoExcept
+    {
+      const __m128i Zero = _mm_setzero_si128();
+
+      _mm_storeu_si128( reinterpret_cast< __m128i* >( Dest ),     _mm_unpacklo_epi8( Chars, Zero ) );
+      _mm_storeu_si128( reinterpret_cast< __m128i* >( Dest + 8 ), _mm_unpackhi_epi8( Chars, Zero ) );
+    }
+
+    inline void WidenAscii( const __m128i Chars, char32_t *const Dest ) NoExcept
+    {
+      const __m128i Zero = _mm_setzero_si128();
+
+      const __m128i Low  = _mm_unpacklo_epi8( Chars, Zero );
+      const __m128i High = _mm_unpackhi_epi8( Chars, Zero );
+
+      _mm_storeu_si128( reinterpret_cast< __m128i* >( Dest ),      _mm_unpacklo_epi16( Low,  Zero ) );
+      _mm_storeu_si128( reinterpret_cast< __m128i* >( Dest + 4 ),  _mm_unpackhi_epi16( Low,  Zero ) );
+      _mm_storeu_si128( reinterpret_cast< __m128i* >( Dest + 8 ),  _mm_unpacklo_epi16( High, Zero ) );
+      _mm_storeu_si128( reinterpret_cast< __m128i* >( Dest + 12 ), _mm_unpackhi_epi16( High, Zero ) );
+    }
+
+    // TCHAR is wchar_t on most platforms, it is the same size as one of the others
+    template < typename CharType >
+    inline void WidenAscii( const __m128i Chars, CharType *const Dest ) NoExcept
+    {
+      using FSameSize = typename std::conditional< sizeof( CharType ) == 2, char16_t, char32_t >::type;
+
+      WidenAscii( Chars, reinterpret_cast< FSameSize* >( Dest ) );
+    }
+#endif
+  }
+
+  // Decodes UTF-8 into Dest, which needs room for Size characters. UTF-8 never takes fewer bytes than characters, so that is always enough.
+  // Runs of ASCII, which is nearly all of our text, are widened 16 bytes at a time. A leading byte order mark is skipped.
+  // Returns how many characters were written.
+  template < typename CharType >
+  size_t DecodeUtf8( const char *const Text, const size_t Size, CharType *const Dest ) NoExcept
+  {
+    static_assert( sizeof( CharType ) == 2 || sizeof( CharType ) == 4, "Can only decode into UTF-16 or UTF-32!" );
+
+    const uint8_t       *Iter = reinterpret_cast< const uint8_t* >( Text );
+    const uint8_t *const End  = Iter + Size;
+
+    if( Size >= 3 && Iter[ 0 ] == 0xEF && Iter[ 1 ] == 0xBB && Iter[ 2 ] == 0xBF ) Iter += 3;
+
+    CharType *Out = Dest;
+
+    while( Iter != End )
+    {
+#if INTERACTION_SCANNER_AVX2 || INTERACTION_SCANNER_SSE2
+      if( End - Iter >= 16 )
+      {
+        const __m128i Chars = _mm_loadu_si128( reinterpret_cast< const __m128i* >( Iter ) );
+
+        const uint32_t NonAscii = static_cast< uint32_t >( _mm_movemask_epi8( Chars ) ); // Only ASCII has the high bit clear
+
+        if( !NonAscii )
+        {
+          Detail::WidenAscii( Chars, Out );
+
+          Iter += 16;
+          Out  += 16;
+
+          continue;
+        }
+
+        // Copy the ASCII up to the first multi-byte sequence, the rest of the stride is checked again after it
+        for( const uint8_t *const AsciiEnd = Iter + CountTrailingZeros( NonAscii ); Iter != AsciiEnd; ++Iter ) *Out++ = static_cast< CharType >( *Iter );
+      }
+#endif
+
+      if( *Iter < 0x80 )
+      {
+        *Out++ = static_cast< CharType >( *Iter++ );
+
+        continue;
+      }
+
+      Out += Detail::WriteCodePoint( Detail::DecodeSequence( Iter, End ), Out );
+    }
+
+    return static_cast< size_t >( Out - Dest );
+  }
+}
@@ -0,0 +1,183 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionTextHotReload.cpp
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#include "Public/InteractionText/InteractionTextHotReload.h"
+
+#if WITH_EDITOR
+
+// Unreal Includes
+#include "DirectoryWatcherModule.h"
+#include "Kismet/KismetSystemLibrary.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+
+// Our Includes
+#include "Public/InteractionText/InteractionBlockIndex.h"
+#include "Public/InteractionText/InteractionMarkupScanner.h"
+
+// STL Includes
+#include <cstring> // memchr
+
+// The watcher can't be registered until the DirectoryWatcher module can be loaded
+static struct FStartHotReload
+{
+  FStartHotReload() NoExcept
+  {
+    FCoreDelegates::OnPostEngineInit.AddLambda( []()NoExcept->void
+    {
+      if( GIsEditor && !IsRunningCommandlet() ) FInteractionTextHotReload::Get();
+    } );
+  }
+} StartHotReload;
+
+FInteractionTextHotReload &FInteractionTextHotReload::Get() NoExcept
+{
+  static FInteractionTextHotReload HotReload;
+
+  return HotReload;
+}
+
+FInteractionTextHotReload::FInteractionTextHotReload() NoExcept :
+Directory{ FPaths::ConvertRelativePathToFull( UKismetSystemLibrary::GetProjectContentDirectory() + "InteractionTextFiles/" ) }
+{
+  FDirectoryWatcherModule &WatcherModule = FModuleManager::LoadModuleChecked< FDirectoryWatcherModule >( TEXT( "DirectoryWatcher" ) );
+
+  IDirectoryWatcher *const Watcher = WatcherModule.Get();
+
+  DebugAssert( !Watcher, "Interaction text hot reload is unavailable, there is no directory watcher on this platform!", return )
+
+  Watcher->RegisterDirectoryChangedCallback_Handle( Directory,
+                                                    IDirectoryWatcher::FDirectoryChanged::CreateRaw( this, &FInteractionTextHotReload::OnDirectoryChanged ),
+                                                    WatcherHandle );
+}
+
+FInteractionTextHotReload::~FInteractionTextHotReload() NoExcept
+{
+  // The module is already gone if the engine is shutting down
+  if( FDirectoryWatcherModule *const WatcherModule = FModuleManager::GetModulePtr< FDirectoryWatcherModule >( TEXT( "DirectoryWatcher" ) ) )
+  {
+    if( IDirectoryWatcher *const Watcher = WatcherModule->Get() ) Watcher->UnregisterDirectoryChangedCallback_Handle( Directory, WatcherHandle );
+  }
+}
+
+void FInteractionTextHotReload::OnDirectoryChanged( const TArray< FFileChangeData > &Changes ) NoExcept
+{
+  TSet< FName > Changed; // Editors tend to report a save as multiple changes
+
+  for( const FFileChangeData &Iter : Changes )
+  {
+    // Files directly in the folder only, the Cooked folder is handled by the commandlet
+    if( FPaths::GetPath( FPaths::ConvertRelativePathToFull( Iter.Filename ) ) + "/" != Directory ) continue;
+
+    const FName FileName{ *FPaths::GetCleanFilename( Iter.Filename ) };
+
+    if( Iter.Action == FFileChangeData::FCA_Removed )
+    {
+      Files.Remove( FileName );
+
+      FInteractionFileCache::Get().Remove( FileName );
+      FInteractionBlockIndex::Get().Remove( FileName );
+    }
+    else Changed.Add( FileName );
+  }
+
+  for( const FName Iter : Changed ) Reload( Iter );
+}
+
+void FInteractionTextHotReload::Reload( const FName FileName ) NoExcept
+{
+  TArray< uint8 > FullText;
+
+  // The writer's program could still have it open, the next change will pick it up
+  if( !( FFileHelper::LoadFileToArray( FullText, *( UInteractionFileLoader::GetInteractionFilePath( FileName ) ) ) ) ) return;
+
+  const char *const TextBegin = reinterpret_cast< const char* >( FullText.GetData() );
+  const char *const TextEnd   = TextBegin + FullText.Num();
+
+  // Split up and hash every block, text after the last newline is not a full block
+  TArray< TPair< const char*, const char* > > Blocks; // Begin and newline of each block
+  TArray< uint32 >                            LineHashes;
+
+  for( const char *Iter = TextBegin, *Newline;
+       ( Newline = static_cast< const char* >( std::memchr( Iter, InteractionMarkup::BlockDelimiter, TextEnd - Iter ) ) ) != nullptr;
+       Iter = Newline + 1 )
+  {
+    Blocks.Emplace( Iter, Newline );
+    LineHashes.Add( FCrc::MemCrc32( Iter, static_cast< int32 >( Newline - Iter ) ) );
+  }
+
+  FFileState &State = Files.FindOrAdd( FileName );
+
+  const int32 OldCount = State.LineHashes.Num();
+  const int32 NewCount = LineHashes.Num();
+
+  // Which old block each new block can be copied from, -1 if it has to be parsed again.
+  // With the same count every changed line is found exactly, otherwise the matching blocks at the start and end are reused.
+  TArray< int32 > ReuseFrom;
+
+  ReuseFrom.Init( -1, NewCount );
+
+  if( State.TextBlocks.IsValid() ) // Nothing to reuse the first time the file changes
+  {
+    if( OldCount == NewCount )
+    {
+      for( int32 i = 0; i < NewCount; ++i )
+      {
+        if( LineHashes[ i ] == State.LineHashes[ i ] ) ReuseFrom[ i ] = i;
+      }
+    }
+    else
+    {
+      int32 Prefix = 0;
+      int32 Suffix = 0;
+
+      while( Prefix < OldCount && Prefix < NewCount && LineHashes[ Prefix ] == State.LineHashes[ Prefix ] ) ++Prefix;
+
+      while( Suffix < OldCount - Prefix && Suffix < NewCount - Prefix &&
+             LineHashes[ NewCount - 1 - Suffix ] == State.LineHashes[ OldCount - 1 - Suffix ] ) ++Suffix;
+
+      for( int32 i = 0; i < Prefix; ++i ) ReuseFrom[ i ] = i;
+
+      for( int32 i = NewCount - Suffix; i < NewCount; ++i ) ReuseFrom[ i ] = i + OldCount - NewCount; // Shifted by the added or removed lines
+    }
+  }
+
+  TArray< FInteractionText > TextBlocks;
+  TArray< int32 >            ChangedBlocks;
+
+  TextBlocks.SetNum( NewCount );
+
+  for( int32 i = 0; i < NewCount; ++i )
+  {
+    if( ReuseFrom[ i ] >= 0 ) TextBlocks[ i ] = State.TextBlocks->GetBlock( ReuseFrom[ i ] ).ToText();
+    else
+    {
+      UInteractionFileLoader::ParseInteractionBlock( Blocks[ i ].Key, Blocks[ i ].Value - Blocks[ i ].Key, TextBlocks[ i ], FileName );
+
+      ChangedBlocks.Add( i );
+    }
+  }
+
+  // Blocks past the new end were removed, let the listeners know those are gone too
+  for( int32 i = NewCount; i < OldCount; ++i ) ChangedBlocks.Add( i );
+
+  State.LineHashes = std::move( LineHashes );
+  State.TextBlocks = MakeShared< const FInteractionTextBlocks, ESPMode::ThreadSafe >( std::move( TextBlocks ) );
+
+  FInteractionFileCache::Get().Replace( FileName, State.TextBlocks.ToSharedRef() );
+  FInteractionBlockIndex::Get().Remove( FileName );
+
+  if( ChangedBlocks.Num() ) OnFileChanged.Broadcast( FileName, ChangedBlocks );
+}
+
+#endif
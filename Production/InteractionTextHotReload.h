@@ -0,0 +1,62 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionTextHotReload.h
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#pragma once
+
+#if WITH_EDITOR
+
+// Unreal Includes
+#include "CoreMinimal.h"
+#include "IDirectoryWatcher.h"
+
+// Our Includes
+#include "Public/InteractionText/InteractionFileCache.h"
+#include "Public/Utils/Macros.h"
+
+// The file that changed, and the index of every block in it that is new or different
+DECLARE_MULTICAST_DELEGATE_TwoParams( FOnInteractionFileChanged, FName /* FileName */, const TArray< int32 >& /* ChangedBlocks */ );
+
+// Watches Content/InteractionTextFiles/ in the editor and re-parses files as the writers save them.
+// Each line is hashed, so only the blocks that actually changed are parsed again, the rest are reused from the last parse.
+// The new parse replaces the one in the FInteractionFileCache, then OnFileChanged is broadcast on the game thread.
+class VIRIDIAN_API FInteractionTextHotReload
+{
+  public:
+    static FInteractionTextHotReload &Get() NoExcept;
+
+  public:
+    FOnInteractionFileChanged OnFileChanged;
+
+  private:
+    struct FFileState
+    {
+      TArray< uint32 > LineHashes; // One for each block
+
+      FInteractionFileCache::FTextBlocksPtr TextBlocks;
+    };
+
+  private:
+    FInteractionTextHotReload() NoExcept;
+    ~FInteractionTextHotReload() NoExcept;
+
+    void OnDirectoryChanged( const TArray< FFileChangeData > &Changes ) NoExcept;
+
+    void Reload( FName FileName ) NoExcept;
+
+  private:
+    FDelegateHandle WatcherHandle;
+
+    FString Directory;
+
+    TMap< FName, FFileState > Files; // Only the files that changed since the editor started
+};
+
+#endif
@@ -0,0 +1,172 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionTextLayout.cpp
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#include "Public/InteractionText/InteractionTextLayout.h"
+
+// Unreal Includes
+#include "Fonts/FontMeasure.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Rendering/SlateRenderer.h"
+
+namespace
+{
+  // The measurements for the blocks of a document in one font, each block is measured the first time it is asked for
+  struct FDocumentLayouts
+  {
+    FInteractionDocument::FTextBlocksPtr::WeakPtrType TextBlocks; // Expired once the document is released, or replaced by the hot reload
+
+    TArray< FInteractionTextLayout > Layouts; // One for every block, only valid if it is Measured
+
+    TBitArray<> Measured;
+  };
+
+  // Documents are keyed by address, the weak pointer catches an address being reused
+  struct FLayoutKey
+  {
+    const void *TextBlocks;
+    const UObject *FontObject;
+    int32 Size; // Not the TypefaceFontName, each run's markup picks its own
+
+    bool operator==( const FLayoutKey &Rhs ) const NoExcept
+    {
+      return TextBlocks == Rhs.TextBlocks && FontObject == Rhs.FontObject && Size == Rhs.Size;
+    }
+
+    friend uint32 GetTypeHash( const FLayoutKey &Key ) NoExcept
+    {
+      return HashCombine( HashCombine( PointerHash( Key.TextBlocks ), PointerHash( Key.FontObject ) ), GetTypeHash( Key.Size ) );
+    }
+  };
+
+  // Slate can only measure on the game thread, so the cache does not need a lock
+  TMap< FLayoutKey, FDocumentLayouts > LayoutCache;
+
+  void RemoveExpiredLayouts() NoExcept
+  {
+    for( auto Iter = LayoutCache.CreateIterator(); Iter; ++Iter )
+    {
+      if( !( Iter->Value.TextBlocks.IsValid() ) ) Iter.RemoveCurrent();
+    }
+  }
+
+  // Reads the runs in place, so cooked documents are measured straight out of their mapping
+  FInteractionTextLayout MeasureBlock( const FInteractionTextView &TextBlock, const FSlateFontInfo &Font ) NoExcept
+  {
+    DebugAssert( !( IsInGameThread() ) || !( FSlateApplication::IsInitialized() ), "Interaction text can only be measured on the game thread!",
+                 return FInteractionTextLayout{} )
+
+    const TSharedRef< FSlateFontMeasure > FontMeasure = FSlateApplication::Get().GetRenderer()->GetFontMeasureService();
+
+    // The font for each markup is only built once per block, most blocks only use a couple
+    TArray< FSlateFontInfo, TInlineAllocator< 8 > > MarkupFonts;
+    int32 FontIndices[ FInteractionText::MarkupCombinations ];
+
+    FMemory::Memset( FontIndices, 0xFF, sizeof( FontIndices ) ); // -1 is not built yet
+
+    // Measure takes an FString, so the runs are packed into one and measured in place
+    FString Text;
+
+    Text.Reserve( TextBlock.GetTextLength() );
+
+    for( int32 i = 0; i < TextBlock.GetRunCount(); ++i )
+    {
+      int32 Length;
+
+      const TCHAR *const RunText = TextBlock.GetRunText( i, Length );
+
+      Text.AppendChars( RunText, Length );
+    }
+
+    int32 Offset = 0;
+
+    FInteractionTextLayout Layout;
+
+    Layout.RunWidths.Reserve( TextBlock.GetRunCount() );
+
+    for( int32 i = 0; i < TextBlock.GetRunCount(); ++i )
+    {
+      int32 Length;
+
+      TextBlock.GetRunText( i, Length );
+
+      const int32 Markup = TextBlock.GetRunMarkup( i );
+
+      if( FontIndices[ Markup ] < 0 ) FontIndices[ Markup ] = MarkupFonts.Add( UInteractionTextLayoutLibrary::GetMarkupFont( Font, Markup ) );
+
+      // The end index is inclusive
+      const FVector2D Size = Length ? FontMeasure->Measure( Text, Offset, Offset + Length - 1, MarkupFonts[ FontIndices[ Markup ] ], false ) :
+                                      FVector2D::ZeroVector;
+
+      Offset += Length;
+
+      Layout.RunWidths.Add( Size.X );
+
+      Layout.Width += Size.X;
+      Layout.Height = FMath::Max( Layout.Height, Size.Y );
+    }
+
+    return Layout; // NRVO
+  }
+}
+
+FSlateFontInfo UInteractionTextLayoutLibrary::GetMarkupFont( const FSlateFontInfo &Font, const int32 Markup ) NoExcept
+{
+  FSlateFontInfo MarkupFont = Font;
+
+  MarkupFont.TypefaceFontName = FInteractionText::GetMarkupName( Markup );
+
+  return MarkupFont; // NRVO
+}
+
+FInteractionTextLayout UInteractionTextLayoutLibrary::MeasureInteractionBlock( const FInteractionText &TextBlock, const FSlateFontInfo &Font ) NoExcept
+{
+  return MeasureBlock( FInteractionTextView{ TextBlock }, Font );
+}
+
+FInteractionTextLayout UInteractionTextLayoutLibrary::GetDocumentLayout( const FInteractionDocument &Document, const int32 Block,
+                                                                         const FSlateFontInfo &Font ) NoExcept
+{
+  const FInteractionTextView TextBlock = Document.GetBlock( Block );
+
+  DebugAssert( !( TextBlock.IsValid() ), "Block %i is out of range, the document only has %i blocks!", return FInteractionTextLayout{},
+               Block, Document.Num() )
+
+  const FInteractionDocument::FTextBlocksPtr &TextBlocks = Document.GetTextBlocks();
+
+  const FLayoutKey Key{ TextBlocks.Get(), Font.FontObject, Font.Size };
+
+  FDocumentLayouts *DocumentLayouts = LayoutCache.Find( Key );
+
+  if( !DocumentLayouts || DocumentLayouts->TextBlocks.Pin() != TextBlocks )
+  {
+    RemoveExpiredLayouts(); // Only done on a miss, a widget showing a conversation hits every frame
+
+    DocumentLayouts = &( LayoutCache.Add( Key ) );
+
+    DocumentLayouts->TextBlocks = TextBlocks;
+    DocumentLayouts->Layouts.SetNum( TextBlocks->Num() );
+    DocumentLayouts->Measured.Init( false, TextBlocks->Num() );
+  }
+
+  // A conversation only shows a few of the blocks in a file, so the rest are never measured
+  if( !( DocumentLayouts->Measured[ Block ] ) )
+  {
+    DocumentLayouts->Layouts[ Block ] = MeasureBlock( TextBlock, Font );
+    DocumentLayouts->Measured[ Block ] = true;
+  }
+
+  return DocumentLayouts->Layouts[ Block ];
+}
+
+void UInteractionTextLayoutLibrary::EmptyLayoutCache() NoExcept
+{
+  LayoutCache.Empty();
+}
@@ -0,0 +1,67 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionTextLayout.h
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#pragma once
+
+// This must be first
+#include "ObjectMacros.h"
+
+// Unreal Includes
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "Fonts/SlateFontInfo.h"
+
+// Our Includes
+#include "Public/InteractionText/InteractionFileLoader.h"
+#include "Public/Utils/Macros.h"
+
+// This must be last
+#include "InteractionTextLayout.generated.h"
+
+// How wide each run of a block is when drawn with its markup's font, so the widget can place the draws without measuring them
+USTRUCT( BlueprintType, Category = "Interactions" )
+struct VIRIDIAN_API FInteractionTextLayout
+{
+  GENERATED_BODY()
+
+  public:
+    UPROPERTY( BlueprintReadOnly, Category = "Interactions" )
+    TArray< float > RunWidths; // In the same order as the block's Runs
+
+    UPROPERTY( BlueprintReadOnly, Category = "Interactions" )
+    float Width = 0.0f; // All of the runs on one line
+
+    UPROPERTY( BlueprintReadOnly, Category = "Interactions" )
+    float Height = 0.0f; // The tallest run
+};
+
+UCLASS( Const )
+class VIRIDIAN_API UInteractionTextLayoutLibrary : public UBlueprintFunctionLibrary
+{
+  GENERATED_BODY()
+
+  public:
+    // The font to render a run with, Font's typeface is swapped for the one named after the markups (see FInteractionText::GetMarkupName)
+    UFUNCTION( BlueprintPure, Category = "Interactions" )
+    static FSlateFontInfo GetMarkupFont( const FSlateFontInfo &Font, int32 Markup ) NoExcept;
+
+    // Measures every run of the block, must be called on the game thread
+    UFUNCTION( BlueprintCallable, Category = "Interactions" )
+    static FInteractionTextLayout MeasureInteractionBlock( const FInteractionText &TextBlock, const FSlateFontInfo &Font ) NoExcept;
+
+    // Returns the layout of a block in the document.
+    // Each block is measured the first time it is laid out with a font, later calls only look it up.
+    UFUNCTION( BlueprintCallable, Category = "Interactions" )
+    static FInteractionTextLayout GetDocumentLayout( const FInteractionDocument &Document, int32 Block, const FSlateFontInfo &Font ) NoExcept;
+
+    // Drops every cached measurement, such as when the fonts are changed in the editor
+    UFUNCTION( BlueprintCallable, Category = "Interactions" )
+    static void EmptyLayoutCache() NoExcept;
+};
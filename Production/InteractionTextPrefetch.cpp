@@ -0,0 +1,158 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionTextPrefetch.cpp
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#include "Public/InteractionText/InteractionTextPrefetch.h"
+
+// Unreal Includes
+#include "Async/Async.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "Kismet/KismetSystemLibrary.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+#include "UObject/UObjectGlobals.h"
+
+// Our Includes
+#include "Public/InteractionText/InteractionFileCache.h"
+
+const FName FInteractionTextPrefetch::MetaDataName{ TEXT( "InteractionFile" ) };
+
+// Hook into level loading as soon as the module is loaded, the first map can load before anything else asks for this
+static struct FStartPrefetch
+{
+  FStartPrefetch() NoExcept
+  {
+    FCoreDelegates::OnPostEngineInit.AddLambda( []()NoExcept->void
+    {
+      if( !IsRunningCommandlet() ) FInteractionTextPrefetch::Get();
+    } );
+  }
+} StartPrefetch;
+
+FInteractionTextPrefetch &FInteractionTextPrefetch::Get() NoExcept
+{
+  static FInteractionTextPrefetch Prefetcher;
+
+  return Prefetcher;
+}
+
+FInteractionTextPrefetch::FInteractionTextPrefetch() NoExcept
+{
+  // The persistent level does not go through LevelAddedToWorld
+  FCoreUObjectDelegates::PostLoadMapWithWorld.AddLambda( [ this ]( UWorld *const World )NoExcept->void
+  {
+    if( World ) OnLevelAdded( World->PersistentLevel, World );
+  } );
+
+  FWorldDelegates::LevelAddedToWorld.AddRaw    ( this, &FInteractionTextPrefetch::OnLevelAdded   );
+  FWorldDelegates::LevelRemovedFromWorld.AddRaw( this, &FInteractionTextPrefetch::OnLevelRemoved );
+  FWorldDelegates::OnWorldCleanup.AddRaw       ( this, &FInteractionTextPrefetch::OnWorldCleanup );
+}
+
+FString FInteractionTextPrefetch::GetManifestPath( const FName PackageName ) NoExcept
+{
+  // The package name starts with a '/', such as /Game/Maps/Forest, so the manifests follow the same folders as the maps
+  return UKismetSystemLibrary::GetProjectContentDirectory() + "InteractionTextFiles/Manifests" + PackageName.ToString() + ".manifest";
+}
+
+bool FInteractionTextPrefetch::WriteManifest( const FName PackageName, const TArray< FName > &FileNames ) NoExcept
+{
+  TArray< FString > Lines;
+
+  Lines.Reserve( FileNames.Num() );
+
+  for( const FName Iter : FileNames ) Lines.Add( Iter.ToString() );
+
+  return FFileHelper::SaveStringArrayToFile( Lines, *GetManifestPath( PackageName ) );
+}
+
+void FInteractionTextPrefetch::OnLevelAdded( ULevel *const Level, UWorld *const World ) NoExcept
+{
+  if( Level && World && World->IsGameWorld() ) Prefetch( Level );
+}
+
+void FInteractionTextPrefetch::OnLevelRemoved( ULevel *const Level, UWorld *const World ) NoExcept
+{
+  if( Level ) Release( Level );
+  else if( World )
+  {
+    for( const ULevel *const Iter : World->GetLevels() ) Release( Iter );
+  }
+}
+
+void FInteractionTextPrefetch::OnWorldCleanup( UWorld *const World, bool, bool ) NoExcept
+{
+  OnLevelRemoved( nullptr, World );
+}
+
+void FInteractionTextPrefetch::Prefetch( const ULevel *const Level ) NoExcept
+{
+  // PIE adds a prefix to the map's name, the manifest is under the real package name
+  const FName PackageName{ *UWorld::RemovePIEPrefix( Level->GetOutermost()->GetName() ) };
+
+  TArray< FString > FileNames;
+
+  if( !( FFileHelper::LoadFileToStringArray( FileNames, *GetManifestPath( PackageName ) ) ) ) return; // The level has no interactions
+
+  const TWeakObjectPtr< const ULevel > WeakLevel{ Level };
+
+  {
+    FScopeLock ScopeLock{ &Lock };
+
+    if( Pinned.Contains( WeakLevel ) ) return; // Already added, the persistent level can be reported twice
+
+    Pinned.Add( WeakLevel );
+  }
+
+  AsyncTask( ENamedThreads::AnyBackgroundThreadNormalTask, [ this, WeakLevel, FileNames = std::move( FileNames ) ]()NoExcept->void
+  {
+    for( const FString &Iter : FileNames )
+    {
+      const FName FileName{ *Iter };
+
+      FInteractionFileCache::Get().Pin( FileName ); // Loads it on this thread if it is not already resident
+
+      FScopeLock ScopeLock{ &Lock };
+
+      TArray< FName > *const LevelFiles = Pinned.Find( WeakLevel );
+
+      if( !LevelFiles || WeakLevel.IsStale() ) // The level was removed while we were loading, don't keep anything for it
+      {
+        FInteractionFileCache::Get().Unpin( FileName );
+
+        if( LevelFiles ) // Destroyed without being removed, nothing is left to release the rest
+        {
+          for( const FName Iter : *LevelFiles ) FInteractionFileCache::Get().Unpin( Iter );
+
+          Pinned.Remove( WeakLevel );
+        }
+
+        return;
+      }
+
+      LevelFiles->Add( FileName );
+    }
+  } );
+}
+
+void FInteractionTextPrefetch::Release( const ULevel *const Level ) NoExcept
+{
+  TArray< FName > FileNames;
+
+  {
+    FScopeLock ScopeLock{ &Lock };
+
+    if( !( Pinned.RemoveAndCopyValue( TWeakObjectPtr< const ULevel >{ Level }, FileNames ) ) ) return; // Still alive while it is being removed, so it matches its key
+  }
+
+  for( const FName Iter : FileNames ) FInteractionFileCache::Get().Unpin( Iter );
+}
@@ -0,0 +1,61 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionTextPrefetch.h
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#pragma once
+
+// Unreal Includes
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "UObject/WeakObjectPtr.h"
+
+// Our Includes
+#include "Public/Utils/Macros.h"
+
+// Commonly used forward declarations
+class ULevel;
+class UWorld;
+
+// Loads every interaction file a level can use on a background thread as soon as the level is loaded.
+// The files are pinned in the FInteractionFileCache until the level is unloaded, so conversations never touch the disk.
+//
+// Which files a level uses comes from its manifest, written by the CookInteractionText commandlet with -manifests.
+// Files typed into the FileName pin of a UInteractionFileLoader node, in the level's Blueprint or the Blueprint of anything placed in it, are found.
+// Tag any FName, or array of FNames, that holds an interaction file name with meta = ( InteractionFile ) for it to be found too.
+class VIRIDIAN_API FInteractionTextPrefetch
+{
+  public:
+    static const FName MetaDataName;
+
+  public:
+    static FInteractionTextPrefetch &Get() NoExcept;
+
+  public:
+    // Keyed by the map's full package path, such as /Game/Maps/Forest, since maps in different folders can share a name
+    static FString GetManifestPath( FName PackageName ) NoExcept;
+
+    static bool WriteManifest( FName PackageName, const TArray< FName > &FileNames ) NoExcept;
+
+  private:
+    FInteractionTextPrefetch() NoExcept;
+
+    void OnLevelAdded  ( ULevel *Level, UWorld *World ) NoExcept;
+    void OnLevelRemoved( ULevel *Level, UWorld *World ) NoExcept; // A null Level means the whole World
+    void OnWorldCleanup( UWorld *World, bool SessionEnded, bool CleanupResources ) NoExcept;
+
+    void Prefetch( const ULevel *Level ) NoExcept;
+    void Release ( const ULevel *Level ) NoExcept;
+
+  private:
+    FCriticalSection Lock;
+
+    // Unpinned when the level is removed. Weak, so a level loaded at the address of a removed one is not mistaken for it.
+    TMap< TWeakObjectPtr< const ULevel >, TArray< FName > > Pinned;
+};
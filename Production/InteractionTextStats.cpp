@@ -0,0 +1,168 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionTextStats.cpp
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#include "Public/InteractionText/InteractionTextStats.h"
+
+// Unreal Includes
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+// Our Includes
+#include "Public/InteractionText/InteractionFileLoader.h"
+
+DEFINE_STAT( STAT_InteractionText_Read      );
+DEFINE_STAT( STAT_InteractionText_Convert   );
+DEFINE_STAT( STAT_InteractionText_Tokenize  );
+DEFINE_STAT( STAT_InteractionText_BuildRuns );
+
+DEFINE_STAT( STAT_InteractionText_BytesRead      );
+DEFINE_STAT( STAT_InteractionText_Blocks         );
+DEFINE_STAT( STAT_InteractionText_Runs           );
+DEFINE_STAT( STAT_InteractionText_UnknownMarkups );
+DEFINE_STAT( STAT_InteractionText_CacheHits      );
+DEFINE_STAT( STAT_InteractionText_CacheMisses    );
+
+static TAutoConsoleVariable< int32 > CVarRecordStats( TEXT( "Viridian.InteractionText.RecordStats" ), 1,
+                                                      TEXT( "Total the load times and counts of each interaction file for DumpStats, 0 disables it." ) );
+
+static FAutoConsoleCommand DumpStatsCommand( TEXT( "Viridian.InteractionText.DumpStats" ),
+                                             TEXT( "Writes what loading each interaction file has cost to a CSV, slowest first. "
+                                                   "Takes the path, Saved/Profiling/InteractionTextStats.csv by default." ),
+                                             FConsoleCommandWithArgsDelegate::CreateLambda( []( const TArray< FString > &Args )NoExcept->void
+{
+  const FString Path = Args.Num() ? Args[ 0 ] : FPaths::ProfilingDir() / TEXT( "InteractionTextStats.csv" );
+
+  if( FInteractionTextStats::Get().DumpCSV( Path ) ) DebugLogType( "Wrote the interaction text stats to '%s'.", Display, *Path );
+  else                                               DebugLogType( "Unable to write the interaction text stats to '%s'!", Error, *Path );
+} ) );
+
+static FAutoConsoleCommand ResetStatsCommand( TEXT( "Viridian.InteractionText.ResetStats" ), TEXT( "Clears the totals DumpStats writes." ),
+                                              FConsoleCommandDelegate::CreateLambda( []()NoExcept->void
+{
+  FInteractionTextStats::Get().Reset();
+} ) );
+
+void FInteractionTextStats::FRecord::operator+=( const FRecord &Rhs ) NoExcept
+{
+  ReadCycles      += Rhs.ReadCycles;
+  ConvertCycles   += Rhs.ConvertCycles;
+  TokenizeCycles  += Rhs.TokenizeCycles;
+  BuildRunsCycles += Rhs.BuildRunsCycles;
+
+  BytesRead      += Rhs.BytesRead;
+  Blocks         += Rhs.Blocks;
+  Runs           += Rhs.Runs;
+  UnknownMarkups += Rhs.UnknownMarkups;
+  CacheHits      += Rhs.CacheHits;
+  CacheMisses    += Rhs.CacheMisses;
+  Loads          += Rhs.Loads;
+}
+
+FInteractionTextStats &FInteractionTextStats::Get() NoExcept
+{
+  static FInteractionTextStats Stats;
+
+  return Stats;
+}
+
+void FInteractionTextStats::CountBlocks( FRecord &Record, const TArray< FInteractionText > &TextBlocks ) NoExcept
+{
+  Record.Blocks += TextBlocks.Num();
+
+  for( const FInteractionText &Iter : TextBlocks ) Record.Runs += Iter.Runs.Num();
+}
+
+void FInteractionTextStats::Add( const FName FileName, const FRecord &Record ) NoExcept
+{
+  INC_DWORD_STAT_BY( STAT_InteractionText_BytesRead,      Record.BytesRead      );
+  INC_DWORD_STAT_BY( STAT_InteractionText_Blocks,         Record.Blocks         );
+  INC_DWORD_STAT_BY( STAT_InteractionText_Runs,           Record.Runs           );
+  INC_DWORD_STAT_BY( STAT_InteractionText_UnknownMarkups, Record.UnknownMarkups );
+
+  if( !( CVarRecordStats.GetValueOnAnyThread() ) ) return;
+
+  FScopeLock ScopeLock{ &Lock };
+
+  Files.FindOrAdd( FileName ) += Record;
+}
+
+void FInteractionTextStats::AddCacheHit( const FName FileName ) NoExcept
+{
+  INC_DWORD_STAT( STAT_InteractionText_CacheHits );
+
+  if( !( CVarRecordStats.GetValueOnAnyThread() ) ) return;
+
+  FScopeLock ScopeLock{ &Lock };
+
+  ++( Files.FindOrAdd( FileName ).CacheHits );
+}
+
+void FInteractionTextStats::AddCacheMiss( const FName FileName ) NoExcept
+{
+  INC_DWORD_STAT( STAT_InteractionText_CacheMisses );
+
+  if( !( CVarRecordStats.GetValueOnAnyThread() ) ) return;
+
+  FScopeLock ScopeLock{ &Lock };
+
+  ++( Files.FindOrAdd( FileName ).CacheMisses );
+}
+
+bool FInteractionTextStats::DumpCSV( const FString &Path ) const NoExcept
+{
+  TArray< TPair< FName, FRecord > > Sorted;
+
+  {
+    FScopeLock ScopeLock{ &Lock };
+
+    Sorted.Reserve( Files.Num() );
+
+    for( const auto &Iter : Files ) Sorted.Emplace( Iter.Key, Iter.Value );
+  }
+
+  const auto TotalCycles = []( const FRecord &Record )NoExcept->uint64
+  {
+    return Record.ReadCycles + Record.ConvertCycles + Record.TokenizeCycles + Record.BuildRunsCycles;
+  };
+
+  Sorted.Sort( [ &TotalCycles ]( const TPair< FName, FRecord > &Lhs, const TPair< FName, FRecord > &Rhs )NoExcept->bool
+  {
+    return TotalCycles( Lhs.Value ) > TotalCycles( Rhs.Value );
+  } );
+
+  const auto Milliseconds = []( const uint64 Cycles )NoExcept->double
+  {
+    return FPlatformTime::ToMilliseconds64( Cycles );
+  };
+
+  FString CSV = TEXT( "File,TotalMs,ReadMs,ConvertMs,TokenizeMs,BuildRunsMs,Loads,BytesRead,Blocks,Runs,UnknownMarkups,CacheHits,CacheMisses\n" );
+
+  for( const TPair< FName, FRecord > &Iter : Sorted )
+  {
+    const FRecord &Record = Iter.Value;
+
+    CSV += FString::Printf( TEXT( "%s,%.3f,%.3f,%.3f,%.3f,%.3f,%lld,%lld,%lld,%lld,%lld,%lld,%lld\n" ), *Iter.Key.ToString(),
+                            Milliseconds( TotalCycles( Record ) ), Milliseconds( Record.ReadCycles ), Milliseconds( Record.ConvertCycles ),
+                            Milliseconds( Record.TokenizeCycles ), Milliseconds( Record.BuildRunsCycles ), Record.Loads, Record.BytesRead,
+                            Record.Blocks, Record.Runs, Record.UnknownMarkups, Record.CacheHits, Record.CacheMisses );
+  }
+
+  return FFileHelper::SaveStringToFile( CSV, *Path );
+}
+
+void FInteractionTextStats::Reset() NoExcept
+{
+  FScopeLock ScopeLock{ &Lock };
+
+  Files.Empty();
+}
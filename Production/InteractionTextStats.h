@@ -0,0 +1,103 @@
+/*!------------------------------------------------------------------------------
+\file   InteractionTextStats.h
+
+\author Garrett Conti
+
+\par    Project: VIRIDIAN
+\par    Course:  GAM300
+
+\par    COPYRIGHT (C) 2018 BY DIGIPEN CORP, USA. ALL RIGHTS RESERVED.
+------------------------------------------------------------------------------ */
+
+#pragma once
+
+// Unreal Includes
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Stats/Stats.h"
+
+// Our Includes
+#include "Public/Utils/Macros.h"
+
+// Commonly used forward declarations
+struct FInteractionText;
+
+// Shown with "stat InteractionText", the phases are also named events in external profilers with -statnamedevents
+DECLARE_STATS_GROUP( TEXT( "InteractionText" ), STATGROUP_InteractionText, STATCAT_Advanced );
+
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Read" ),       STAT_InteractionText_Read,      STATGROUP_InteractionText, VIRIDIAN_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Convert" ),    STAT_InteractionText_Convert,   STATGROUP_InteractionText, VIRIDIAN_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Tokenize" ),   STAT_InteractionText_Tokenize,  STATGROUP_InteractionText, VIRIDIAN_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Build Runs" ), STAT_InteractionText_BuildRuns, STATGROUP_InteractionText, VIRIDIAN_API );
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN( TEXT( "Bytes Read" ),       STAT_InteractionText_BytesRead,      STATGROUP_InteractionText, VIRIDIAN_API );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN( TEXT( "Blocks" ),           STAT_InteractionText_Blocks,         STATGROUP_InteractionText, VIRIDIAN_API );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN( TEXT( "Runs" ),             STAT_InteractionText_Runs,           STATGROUP_InteractionText, VIRIDIAN_API );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN( TEXT( "Unknown Markups" ),  STAT_InteractionText_UnknownMarkups, STATGROUP_InteractionText, VIRIDIAN_API );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN( TEXT( "Cache Hits" ),       STAT_InteractionText_CacheHits,      STATGROUP_InteractionText, VIRIDIAN_API );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN( TEXT( "Cache Misses" ),     STAT_InteractionText_CacheMisses,    STATGROUP_InteractionText, VIRIDIAN_API );
+
+// Totals what loading each interaction file has cost, so the slowest files can be found from a playtest.
+// Dump them with "Viridian.InteractionText.DumpStats [Path]", which writes a CSV sorted by the total time.
+// Recording can be turned off with Viridian.InteractionText.RecordStats, the STAT counters are still updated.
+class VIRIDIAN_API FInteractionTextStats
+{
+  public:
+    // One parse fills a record without any locking, then it is added to the file's totals in one go
+    struct FRecord
+    {
+      void operator+=( const FRecord &Rhs ) NoExcept;
+
+      uint64 ReadCycles      = 0;
+      uint64 ConvertCycles   = 0; // UTF-8 to TCHAR
+      uint64 TokenizeCycles  = 0; // Finding the delimiters and markups, and pushing back the runs
+      uint64 BuildRunsCycles = 0; // Coalescing the runs, interning the text, and copying out the finished blocks
+
+      int64 BytesRead      = 0; // Bytes of markup, cooked and archived files are not counted
+      int64 Blocks         = 0;
+      int64 Runs           = 0;
+      int64 UnknownMarkups = 0;
+      int64 CacheHits      = 0;
+      int64 CacheMisses    = 0;
+      int64 Loads          = 0; // How many times the file was read or parsed
+    };
+
+    // Adds the time until it goes out of scope to one of the record's phases
+    class FPhaseScope
+    {
+      public:
+        explicit FPhaseScope( uint64 &PhaseCycles ) NoExcept : Cycles( PhaseCycles ), Start( FPlatformTime::Cycles64() ) {}
+
+        ~FPhaseScope() NoExcept { Cycles += FPlatformTime::Cycles64() - Start; }
+
+      private:
+        uint64 &Cycles;
+
+        const uint64 Start;
+    };
+
+  public:
+    static FInteractionTextStats &Get() NoExcept;
+
+  public:
+    // Counts the blocks and runs of a finished load into the record
+    static void CountBlocks( FRecord &Record, const TArray< FInteractionText > &TextBlocks ) NoExcept;
+
+    void Add( FName FileName, const FRecord &Record ) NoExcept;
+
+    void AddCacheHit ( FName FileName ) NoExcept;
+    void AddCacheMiss( FName FileName ) NoExcept;
+
+    // Returns false if the file could not be written
+    bool DumpCSV( const FString &Path ) const NoExcept;
+
+    void Reset() NoExcept;
+
+  private:
+    FInteractionTextStats() NoExcept {}
+
+  private:
+    mutable FCriticalSection Lock;
+
+    TMap< FName, FRecord > Files;
+};